@@ -0,0 +1,209 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+/*
+ * Measures OpenAL Soft's mixer CPU use per active voice source.
+ *
+ * Renders voice through a loopback device, so that timing is not bound to a
+ * sound card. Each source loops a 48 kHz mono buffer, the rate TeamSpeak
+ * gives voice in, and is positioned around the listener as the plugin does.
+ * At 44100 Hz output every source is resampled before mixing, at 48000 Hz
+ * the buffers are mixed as they are. Each case is rendered with and without
+ * HRTF. OpenAL Soft applies HRTF only with a data set at the output rate,
+ * so the cases report whether HRTF was actually on.
+ *
+ * Prints milliseconds of CPU time per second of rendered audio, and the
+ * cost of one source derived from the difference between source counts.
+ */
+
+#include <AL/al.h>
+#include <AL/alc.h>
+#include <AL/alext.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#ifndef ALC_HRTF_SOFT
+#define ALC_HRTF_SOFT 0x1992
+#endif
+
+namespace
+{
+
+const double PI = 3.14159265358979323846;
+const int VOICE_SAMPLE_RATE = 48000;
+const int RENDER_FRAMES = 1024;
+const int RENDER_SECONDS = 20;
+const int SOURCE_COUNTS[] = { 1, 8, 32 };
+const int SOURCE_COUNT_CASES = sizeof( SOURCE_COUNTS ) / sizeof( SOURCE_COUNTS[0] );
+
+LPALCLOOPBACKOPENDEVICESOFT alcLoopbackOpenDevice;
+LPALCISRENDERFORMATSUPPORTEDSOFT alcIsRenderFormatSupported;
+LPALCRENDERSAMPLESSOFT alcRenderSamples;
+
+bool loadLoopbackFunctions()
+{
+	if( !alcIsExtensionPresent( NULL, "ALC_SOFT_loopback" ) )
+	{
+		return false;
+	}
+	alcLoopbackOpenDevice = (LPALCLOOPBACKOPENDEVICESOFT) alcGetProcAddress( NULL, "alcLoopbackOpenDeviceSOFT" );
+	alcIsRenderFormatSupported = (LPALCISRENDERFORMATSUPPORTEDSOFT) alcGetProcAddress( NULL, "alcIsRenderFormatSupportedSOFT" );
+	alcRenderSamples = (LPALCRENDERSAMPLESSOFT) alcGetProcAddress( NULL, "alcRenderSamplesSOFT" );
+	return alcLoopbackOpenDevice && alcIsRenderFormatSupported && alcRenderSamples;
+}
+
+// one second of a voice like tone, long enough to not loop audibly often
+std::vector<short> makeVoice()
+{
+	std::vector<short> samples( VOICE_SAMPLE_RATE );
+	for( int i = 0; i < VOICE_SAMPLE_RATE; i++ )
+	{
+		const double time = double( i ) / VOICE_SAMPLE_RATE;
+		samples[i] = short( 8000 * std::sin( 2 * PI * 220 * time ) + 4000 * std::sin( 2 * PI * 1370 * time ) );
+	}
+	return samples;
+}
+
+struct Result
+{
+	Result() : valid( false ), hrtf( false ), milliseconds( 0 ) {}
+
+	bool valid;
+	bool hrtf;
+	double milliseconds;
+};
+
+Result measure( int sampleRate, bool hrtf, int sourceCount, const std::vector<short> &voice )
+{
+	Result result;
+	ALCdevice *device = alcLoopbackOpenDevice( NULL );
+	if( !device )
+	{
+		return result;
+	}
+	if( !alcIsRenderFormatSupported( device, sampleRate, ALC_STEREO_SOFT, ALC_SHORT_SOFT ) )
+	{
+		alcCloseDevice( device );
+		return result;
+	}
+	// same attributes as the plugin's output context, see privateimpl.cpp
+	const ALCint attrs[] = {
+		ALC_FREQUENCY, sampleRate,
+		ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT,
+		ALC_FORMAT_TYPE_SOFT, ALC_SHORT_SOFT,
+		ALC_HRTF_SOFT, hrtf? ALC_TRUE: ALC_FALSE,
+		0
+	};
+	ALCcontext *context = alcCreateContext( device, attrs );
+	if( !context )
+	{
+		alcCloseDevice( device );
+		return result;
+	}
+	alcMakeContextCurrent( context );
+	alDopplerFactor( 0 );
+
+	ALCint hrtfState = ALC_FALSE;
+	alcGetIntegerv( device, ALC_HRTF_SOFT, 1, &hrtfState );
+	result.hrtf = hrtfState == ALC_TRUE;
+
+	ALuint buffer = 0;
+	alGenBuffers( 1, &buffer );
+	alBufferData( buffer, AL_FORMAT_MONO16, voice.data(), ALsizei( voice.size() * sizeof( short ) ), VOICE_SAMPLE_RATE );
+
+	std::vector<ALuint> sources( sourceCount );
+	alGenSources( sourceCount, sources.data() );
+	for( int i = 0; i < sourceCount; i++ )
+	{
+		// spread around the listener, offset so sources are out of phase
+		const double angle = 2 * PI * i / sourceCount;
+		alSource3f( sources[i], AL_POSITION, ALfloat( 10 * std::sin( angle ) ), 0, ALfloat( -10 * std::cos( angle ) ) );
+		alSourcei( sources[i], AL_BUFFER, buffer );
+		alSourcei( sources[i], AL_LOOPING, AL_TRUE );
+		alSourcei( sources[i], AL_SAMPLE_OFFSET, ( i * 997 ) % VOICE_SAMPLE_RATE );
+		alSourcePlay( sources[i] );
+	}
+
+	if( alGetError() == AL_NO_ERROR )
+	{
+		std::vector<short> output( RENDER_FRAMES * 2 );
+		const int renderCount = sampleRate * RENDER_SECONDS / RENDER_FRAMES;
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for( int i = 0; i < renderCount; i++ )
+		{
+			alcRenderSamples( device, output.data(), RENDER_FRAMES );
+		}
+		const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		result.milliseconds = elapsed.count() / ( double( renderCount ) * RENDER_FRAMES / sampleRate );
+		result.valid = true;
+	}
+
+	alDeleteSources( sourceCount, sources.data() );
+	alDeleteBuffers( 1, &buffer );
+	alcMakeContextCurrent( NULL );
+	alcDestroyContext( context );
+	alcCloseDevice( device );
+	return result;
+}
+
+}
+
+int main()
+{
+	if( !loadLoopbackFunctions() )
+	{
+		std::printf( "OpenAL library has no ALC_SOFT_loopback extension\n" );
+		return 1;
+	}
+	const std::vector<short> voice = makeVoice();
+	const int sampleRates[] = { 44100, VOICE_SAMPLE_RATE };
+
+	std::printf( "ms per second of audio" );
+	for( int i = 0; i < SOURCE_COUNT_CASES; i++ )
+	{
+		std::printf( "  %2d src", SOURCE_COUNTS[i] );
+	}
+	std::printf( "  per src\n" );
+	for( int hrtf = 0; hrtf <= 1; hrtf++ )
+	{
+		for( int rate = 0; rate < 2; rate++ )
+		{
+			Result results[SOURCE_COUNT_CASES];
+			for( int i = 0; i < SOURCE_COUNT_CASES; i++ )
+			{
+				results[i] = measure( sampleRates[rate], hrtf, SOURCE_COUNTS[i], voice );
+			}
+			const char *mode = !results[0].valid? "unsupported": results[0].hrtf? "hrtf": hrtf? "no hrtf data": "panned";
+			std::printf( "%5d Hz %-13s", sampleRates[rate], mode );
+			for( int i = 0; i < SOURCE_COUNT_CASES; i++ )
+			{
+				std::printf( "  %6.2f", results[i].milliseconds );
+			}
+			const Result &first = results[0];
+			const Result &last = results[SOURCE_COUNT_CASES - 1];
+			const int sourceDifference = SOURCE_COUNTS[SOURCE_COUNT_CASES - 1] - SOURCE_COUNTS[0];
+			std::printf( "  %7.3f\n", ( last.milliseconds - first.milliseconds ) / sourceDifference );
+		}
+	}
+	return 0;
+}
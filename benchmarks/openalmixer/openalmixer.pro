@@ -0,0 +1,40 @@
+# TessuMod: Mod for integrating TeamSpeak into World of Tanks
+# Copyright (C) 2014  Janne Hakonen
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+# USA
+
+
+# Benchmark of OpenAL Soft's mixer CPU use at 44100 and 48000 Hz output rates,
+# links against OpenAL Soft directly, run with HRTF data sets for both rates:
+#     qmake && make
+#     ALSOFT_CONF=openalmixer.conf ./openalmixer_benchmark
+# where openalmixer.conf contains:
+#     [general]
+#     hrtf_tables = <repo>/etc/hrtfs/mit_kemar-44100.mhr, <repo>/etc/default-48000.mhr
+
+TARGET = openalmixer_benchmark
+TEMPLATE = app
+QT -= core gui
+CONFIG += C++11 console
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../../include
+
+unix:LIBS += -lopenal
+win32:LIBS += -L$$PWD/../../bin -lOpenAL64
+
+SOURCES += \
+	main.cpp
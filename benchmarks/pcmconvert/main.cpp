@@ -0,0 +1,157 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+/*
+ * Compares PcmConvert's downmix kernels against a plain scalar loop.
+ *
+ * First checks that the kernels produce exactly the same samples as the
+ * scalar loop for all frame counts up to a few vectors, so that the vector
+ * body and the scalar tail agree, including values half way between two
+ * integers. Then times both on a typical TeamSpeak voice frame.
+ *
+ * Returns non-zero if any output differs.
+ */
+
+#include "utils/pcmconvert.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+
+// 20 ms of 48 kHz audio, TeamSpeak's frame size
+const int FRAME_COUNT = 960;
+const int ITERATIONS = 20000;
+const int MAX_CHECKED_FRAMES = 67;
+
+short referenceSaturate( float value )
+{
+	return value >= 32767.0f? 32767: value <= -32768.0f? -32768: short( std::lrint( value ) );
+}
+
+void referenceToFloat( const short *input, int frameCount, int channels, float gain, float *output )
+{
+	const float scale = gain * ( 1.0f / 32768.0f ) / channels;
+	for( int frame = 0; frame < frameCount; frame++ )
+	{
+		int sum = 0;
+		for( int channel = 0; channel < channels; channel++ )
+		{
+			sum += input[frame * channels + channel];
+		}
+		output[frame] = sum * scale;
+	}
+}
+
+void referenceToInt16( const short *input, int frameCount, int channels, float gain, short *output )
+{
+	const float scale = gain / channels;
+	for( int frame = 0; frame < frameCount; frame++ )
+	{
+		int sum = 0;
+		for( int channel = 0; channel < channels; channel++ )
+		{
+			sum += input[frame * channels + channel];
+		}
+		output[frame] = referenceSaturate( sum * scale );
+	}
+}
+
+std::vector<short> makeInput( int sampleCount, bool halves )
+{
+	std::vector<short> input( sampleCount );
+	for( int i = 0; i < sampleCount; i++ )
+	{
+		// odd samples at half gain land half way between two integers
+		input[i] = halves? short( ( i % 64 ) * 2 - 63 ): short( std::rand() % 65536 - 32768 );
+	}
+	return input;
+}
+
+bool check( int channels, float gain, bool halves )
+{
+	bool passed = true;
+	for( int frameCount = 0; frameCount <= MAX_CHECKED_FRAMES; frameCount++ )
+	{
+		const std::vector<short> input = makeInput( frameCount * channels + 1, halves );
+		std::vector<float> floats( frameCount + 1 ), expectedFloats( frameCount + 1 );
+		std::vector<short> shorts( frameCount + 1 ), expectedShorts( frameCount + 1 );
+		PcmConvert::downmixToFloat( input.data(), frameCount, channels, gain, floats.data() );
+		referenceToFloat( input.data(), frameCount, channels, gain, expectedFloats.data() );
+		PcmConvert::downmixToInt16( input.data(), frameCount, channels, gain, shorts.data() );
+		referenceToInt16( input.data(), frameCount, channels, gain, expectedShorts.data() );
+		for( int frame = 0; frame < frameCount; frame++ )
+		{
+			if( floats[frame] != expectedFloats[frame] || shorts[frame] != expectedShorts[frame] )
+			{
+				std::printf( "MISMATCH channels %d, gain %g, frames %d, frame %d: float %g != %g, int16 %d != %d\n",
+							 channels, gain, frameCount, frame, floats[frame], expectedFloats[frame], shorts[frame], expectedShorts[frame] );
+				passed = false;
+				break;
+			}
+		}
+	}
+	return passed;
+}
+
+template <typename T, typename Function>
+double measure( Function function, const short *input, int channels, T *output )
+{
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for( int i = 0; i < ITERATIONS; i++ )
+	{
+		function( input, FRAME_COUNT, channels, 1.0f, output );
+	}
+	const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / ITERATIONS;
+}
+
+}
+
+int main()
+{
+	bool passed = true;
+	for( int channels = 1; channels <= 3; channels++ )
+	{
+		passed = check( channels, 1.0f, false ) && passed;
+		passed = check( channels, 0.5f, true ) && passed;
+		passed = check( channels, 4.0f, false ) && passed;
+	}
+	std::printf( "consistency: %s\n", passed? "ok": "FAILED" );
+
+	std::printf( "ns per %d frame call   kernel  scalar\n", FRAME_COUNT );
+	for( int channels = 1; channels <= 2; channels++ )
+	{
+		const std::vector<short> input = makeInput( FRAME_COUNT * channels, false );
+		std::vector<float> floats( FRAME_COUNT );
+		std::vector<short> shorts( FRAME_COUNT );
+		std::printf( "%d ch to float          %7.0f %7.0f\n", channels,
+					 measure( PcmConvert::downmixToFloat, input.data(), channels, floats.data() ),
+					 measure( referenceToFloat, input.data(), channels, floats.data() ) );
+		std::printf( "%d ch to int16          %7.0f %7.0f\n", channels,
+					 measure( PcmConvert::downmixToInt16, input.data(), channels, shorts.data() ),
+					 measure( referenceToInt16, input.data(), channels, shorts.data() ) );
+	}
+	return passed? 0: 1;
+}
@@ -0,0 +1,195 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+/*
+ * Measures the cost of one game state update through the use case layer.
+ *
+ * Drives UseCaseFactory::updateGameState() with real storages and stub
+ * adapters, and compares it with creating a new UseCases object for each
+ * event and deleting it with deleteLater(), as the factory did before it
+ * kept one instance. The change filter is left disabled so that both
+ * forward the same positions to the audio adapter.
+ */
+
+#include "usecases/usecasefactory.h"
+#include "usecases/usecases.h"
+#include "storages/adapterstorage.h"
+#include "storages/camerastorage.h"
+#include "storages/userstorage.h"
+#include "entities/gamestate.h"
+#include "entities/settings.h"
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QStringList>
+#include <QVariant>
+
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+
+const int USER_COUNT = 30;
+const int ITERATIONS = 100000;
+
+class StubAudio : public Interfaces::AudioAdapter
+{
+public:
+	StubAudio() : positionedUsers( 0 ) {}
+	void positionUser( const Entity::User & ) { positionedUsers++; }
+	void removeUser( const Entity::User & ) {}
+	void positionCamera( const Entity::Camera & ) {}
+	void flush() {}
+	void setPlaybackDeviceName( const QString & ) {}
+	void setPlaybackVolume( float ) {}
+	void setEnabled( bool ) {}
+	void setHrtfEnabled( bool ) {}
+	void setHrtfDataSet( const QString & ) {}
+	void setHrtfVoiceLimit( int ) {}
+	QStringList getHrtfDataFileNames() const { return QStringList(); }
+	void playTestSound( Entity::RotateMode, Callback ) {}
+	void setLoggingLevel( int ) {}
+
+	quint64 positionedUsers;
+};
+
+class StubVoiceChat : public Interfaces::VoiceChatAdapter
+{
+public:
+	quint16 getMyUserId() const { return 0; }
+	QString getPlaybackDeviceName() const { return QString(); }
+	float getPlaybackVolume() const { return 1.0f; }
+};
+
+class StubSettingsStorage : public Interfaces::SettingsStorage
+{
+public:
+	Entity::Settings get() const { return Entity::Settings(); }
+	void set( const Entity::Settings & ) {}
+};
+
+struct Fixture
+{
+	Fixture()
+		: adapterStorage( NULL ), cameraStorage( NULL ), userStorage( NULL ), factory( NULL )
+	{
+		adapterStorage.setAudio( Entity::OpenALBackend, &audio );
+		adapterStorage.setVoiceChat( &voiceChat );
+		factory.adapterStorage = &adapterStorage;
+		factory.cameraStorage = &cameraStorage;
+		factory.userStorage = &userStorage;
+		factory.settingsStorage = &settingsStorage;
+	}
+
+	StubAudio audio;
+	StubVoiceChat voiceChat;
+	StubSettingsStorage settingsStorage;
+	Storage::AdapterStorage adapterStorage;
+	Storage::CameraStorage cameraStorage;
+	Storage::UserStorage userStorage;
+	UseCase::UseCaseFactory factory;
+};
+
+// what UseCaseFactory did for every call before it kept one instance
+void updateWithNewUseCases( Fixture &fixture, const Entity::GameState &state )
+{
+	UseCase::UseCases *useCases = new UseCase::UseCases( &fixture.factory );
+	useCases->adapterStorage = &fixture.adapterStorage;
+	useCases->cameraStorage = &fixture.cameraStorage;
+	useCases->userStorage = &fixture.userStorage;
+	useCases->settingsStorage = &fixture.settingsStorage;
+	useCases->updateGameState( state );
+	useCases->deleteLater();
+}
+
+void updateWithFactory( Fixture &fixture, const Entity::GameState &state )
+{
+	fixture.factory.updateGameState( state );
+}
+
+// users are in chat and in game, each event moves movedCount of them and
+// the camera, to a position differing from the user's previous one
+QVector<Entity::GameState> makeEvents( int movedCount )
+{
+	QVector<Entity::GameState> events( USER_COUNT * 2 );
+	for( int i = 0; i < events.size(); i++ )
+	{
+		Entity::GameState &state = events[i];
+		for( int moved = 0; moved < movedCount; moved++ )
+		{
+			Entity::UserPosition position;
+			position.id = ( i + moved ) % USER_COUNT + 1;
+			position.position = Entity::Vector( position.id * 10 + i, 0, i );
+			state.movedUsers.append( position );
+		}
+		state.cameraChanged = true;
+		state.cameraPosition = Entity::Vector( i, 0, 0 );
+		state.cameraDirection = Entity::Vector( 0, 0, 1 );
+	}
+	return events;
+}
+
+template <typename Function>
+double measure( Function function, int movedCount )
+{
+	Fixture fixture;
+	Entity::GameState joined;
+	for( quint16 id = 1; id <= USER_COUNT; id++ )
+	{
+		fixture.factory.addChatUser( id );
+		joined.addedUsers.append( id );
+	}
+	fixture.factory.updateGameState( joined );
+
+	const QVector<Entity::GameState> events = makeEvents( movedCount );
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for( int i = 0; i < ITERATIONS; i++ )
+	{
+		function( fixture, events[i % events.size()] );
+		// the plugin returns to TeamSpeak's event loop between events
+		QCoreApplication::sendPostedEvents( NULL, QEvent::DeferredDelete );
+	}
+	const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	if( fixture.audio.positionedUsers < quint64( ITERATIONS ) * movedCount )
+	{
+		std::printf( "expected every moved user to be positioned\n" );
+	}
+	return elapsed.count() / ITERATIONS;
+}
+
+}
+
+int main( int argc, char *argv[] )
+{
+	QCoreApplication application( argc, argv );
+
+	std::printf( "ns per event           persistent  new per event\n" );
+	// one moved user is a single position change, all moved is a full tick
+	const int movedCounts[] = { 1, USER_COUNT };
+	for( int i = 0; i < 2; i++ )
+	{
+		const int movedCount = movedCounts[i];
+		std::printf( "%2d of %d users moved  %10.0f %14.0f\n", movedCount, USER_COUNT,
+					 measure( updateWithFactory, movedCount ),
+					 measure( updateWithNewUseCases, movedCount ) );
+	}
+	return 0;
+}
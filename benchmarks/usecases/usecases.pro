@@ -0,0 +1,52 @@
+# TessuMod: Mod for integrating TeamSpeak into World of Tanks
+# Copyright (C) 2014  Janne Hakonen
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+# USA
+
+
+# Benchmark of UseCaseFactory::updateGameState() with stub adapters, compares
+# the persistent use cases instance against a new instance per event, run
+# with optimizations enabled:
+#     qmake CONFIG+=release && make && ./usecases_benchmark
+
+TARGET = usecases_benchmark
+TEMPLATE = app
+CONFIG += C++11 console
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../../src
+
+SOURCES += \
+	main.cpp \
+	../../src/entities/camera.cpp \
+	../../src/entities/failures.cpp \
+	../../src/entities/gamestate.cpp \
+	../../src/entities/settings.cpp \
+	../../src/entities/user.cpp \
+	../../src/entities/vector.cpp \
+	../../src/storages/adapterstorage.cpp \
+	../../src/storages/camerastorage.cpp \
+	../../src/storages/userstorage.cpp \
+	../../src/usecases/changefilter.cpp \
+	../../src/usecases/usecasefactory.cpp \
+	../../src/usecases/usecases.cpp \
+	../../src/utils/logging.cpp
+
+HEADERS += \
+	../../src/storages/camerastorage.h \
+	../../src/storages/userstorage.h \
+	../../src/usecases/usecasefactory.h \
+	../../src/usecases/usecases.h
@@ -67,6 +67,11 @@ void AudioAdapter::positionCamera( const Entity::Camera &camera )
 	driver->positionCamera( camera.position, forward, up );
 }
 
+void AudioAdapter::flush()
+{
+	driver->flush();
+}
+
 void AudioAdapter::setPlaybackDeviceName( const QString &name )
 {
 	driver->setPlaybackDeviceName( name );
@@ -99,6 +104,11 @@ void AudioAdapter::setHrtfDataSet( const QString &name )
 	driver->setHrtfDataSet( name );
 }
 
+void AudioAdapter::setHrtfVoiceLimit( int limit )
+{
+	driver->setHrtfVoiceLimit( limit );
+}
+
 QStringList AudioAdapter::getHrtfDataFileNames() const
 {
 	return driver->getHrtfDataFileNames();
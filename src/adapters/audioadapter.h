@@ -45,6 +45,7 @@ public:
 	void positionUser( const Entity::User &user );
 	void removeUser( const Entity::User &user );
 	void positionCamera( const Entity::Camera &camera );
+	void flush();
 
 	void setPlaybackDeviceName( const QString &name );
 	void setPlaybackVolume( float volume );
@@ -53,6 +54,7 @@ public:
 
 	void setHrtfEnabled( bool enabled );
 	void setHrtfDataSet( const QString &name );
+	void setHrtfVoiceLimit( int limit );
 	QStringList getHrtfDataFileNames() const;
 
 	void playTestSound( Entity::RotateMode mode, Callback result );
@@ -19,61 +19,41 @@
  */
 
 #include "gamedataadapter.h"
+#include "../entities/gamestate.h"
+#include "../utils/poseextrapolator.h"
+#include "../utils/latency.h"
 
 namespace Adapter
 {
 
 GameDataAdapter::GameDataAdapter( Interfaces::GameDataDriver* driver, Interfaces::UseCaseFactory *useCaseFactory, QObject *parent )
-	: QObject( parent ), useCaseFactory( useCaseFactory )
+	: QObject( parent ), driver( driver ), useCaseFactory( useCaseFactory ), extrapolator( new PoseExtrapolator( this ) )
 {
-	connect( driver->qtObj(), SIGNAL(gameUserAdded(quint16)),
-			 this, SLOT(onGameUserAdded(quint16)) );
-	connect( driver->qtObj(), SIGNAL(gameUserRemoved(quint16)),
-			 this, SLOT(onGameUserRemoved(quint16)) );
-	connect( driver->qtObj(), SIGNAL(gameUserPositionChanged(quint16, Entity::Vector)),
-			 this, SLOT(onGameUserPositionChanged(quint16, Entity::Vector)) );
-	connect( driver->qtObj(), SIGNAL(gameCameraPositionChanged(Entity::Vector)),
-			 this, SLOT(onGameCameraPositionChanged(Entity::Vector)) );
-	connect( driver->qtObj(), SIGNAL(gameCameraDirectionChanged(Entity::Vector)),
-			 this, SLOT(onGameCameraDirectionChanged(Entity::Vector)) );
+	connect( driver->qtObj(), SIGNAL(gameStateChanged(Entity::GameState)),
+			 this, SLOT(onGameStateChanged(Entity::GameState)) );
+	connect( extrapolator, SIGNAL(stateChanged(Entity::GameState)),
+			 this, SLOT(onStateExtrapolated(Entity::GameState)) );
 }
 
-void GameDataAdapter::onGameUserAdded( quint16 id )
+void GameDataAdapter::setPoseUpdateRate( int rate )
 {
-	useCaseFactory->addGameUser( id );
+	extrapolator->setUpdateRate( rate );
 }
 
-void GameDataAdapter::onGameUserRemoved( quint16 id )
+QStringList GameDataAdapter::getStatistics() const
 {
-	useCaseFactory->removeGameUser( id );
+	return driver->getStatistics() + Latency::getReport();
 }
 
-void GameDataAdapter::onGameUserPositionChanged( quint16 id, const Entity::Vector &position )
+void GameDataAdapter::onGameStateChanged( const Entity::GameState &state )
 {
-	useCaseFactory->positionUser( id, position );
+	extrapolator->update( state );
 }
 
-void GameDataAdapter::onGameCameraPositionChanged( const Entity::Vector &position )
+void GameDataAdapter::onStateExtrapolated( const Entity::GameState &state )
 {
-	cameraPosition = position;
-	if( isCameraValid() )
-	{
-		useCaseFactory->positionCamera( cameraPosition, cameraDirection );
-	}
-}
-
-void GameDataAdapter::onGameCameraDirectionChanged( const Entity::Vector &direction )
-{
-	cameraDirection = direction;
-	if( isCameraValid() )
-	{
-		useCaseFactory->positionCamera( cameraPosition, cameraDirection );
-	}
-}
-
-bool GameDataAdapter::isCameraValid() const
-{
-	return cameraDirection != Entity::Vector();
+	Latency::setPendingUpdate( state.writeTime, state.readTime );
+	useCaseFactory->updateGameState( state );
 }
 
 }
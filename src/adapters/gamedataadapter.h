@@ -23,7 +23,13 @@
 #include "../interfaces/adapters.h"
 #include "../interfaces/usecasefactory.h"
 #include "../interfaces/drivers.h"
-#include "../entities/vector.h"
+
+class PoseExtrapolator;
+
+namespace Entity
+{
+class GameState;
+}
 
 namespace Adapter
 {
@@ -35,20 +41,18 @@ class GameDataAdapter : public QObject, public Interfaces::GameDataAdapter
 public:
 	GameDataAdapter( Interfaces::GameDataDriver* driver, Interfaces::UseCaseFactory *useCaseFactory, QObject *parent );
 
-private slots:
-	void onGameUserAdded( quint16 id );
-	void onGameUserRemoved( quint16 id );
-	void onGameUserPositionChanged( quint16 id, const Entity::Vector &position );
-	void onGameCameraPositionChanged( const Entity::Vector &position );
-	void onGameCameraDirectionChanged( const Entity::Vector &direction );
+	// from Interfaces::GameDataAdapter
+	void setPoseUpdateRate( int rate );
+	QStringList getStatistics() const;
 
-private:
-	bool isCameraValid() const;
+private slots:
+	void onGameStateChanged( const Entity::GameState &state );
+	void onStateExtrapolated( const Entity::GameState &state );
 
 private:
+	Interfaces::GameDataDriver *driver;
 	Interfaces::UseCaseFactory *useCaseFactory;
-	Entity::Vector cameraPosition;
-	Entity::Vector cameraDirection;
+	PoseExtrapolator *extrapolator;
 };
 
 }
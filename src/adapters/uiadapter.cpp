@@ -28,6 +28,7 @@
 
 #include <iostream>
 #include <QVariant>
+#include <QMessageBox>
 
 namespace Adapter
 {
@@ -50,6 +51,7 @@ void UiAdapter::showSettingsUi( const Entity::Settings &settings, const QStringL
 		settingsDialog->setHrtfEnabled( settings.hrtfEnabled );
 		settingsDialog->setHrtfDataFileNames( hrtfDataNames );
 		settingsDialog->setHrtfDataSet( settings.hrtfDataSet );
+		settingsDialog->setHrtfVoiceLimit( settings.hrtfVoiceLimit );
 		settingsDialog->setLoggingLevel( settings.audioLoggingLevel );
 		settingsDialog->setOpenALConfFilePath( confPathSource->getFilePath() );
 
@@ -63,6 +65,15 @@ void UiAdapter::showSettingsUi( const Entity::Settings &settings, const QStringL
 	}
 }
 
+void UiAdapter::showStatistics( const QStringList &lines, QWidget *parent )
+{
+	foreach( const QString &line, lines )
+	{
+		Log::info() << line;
+	}
+	QMessageBox::information( parent, tr("TessuMod Plugin Statistics"), lines.join( "\n" ) );
+}
+
 void UiAdapter::onSettingsChanged()
 {
 	useCaseFactory->saveSettings( collectSettingsFromUI() );
@@ -112,6 +123,7 @@ Entity::Settings UiAdapter::collectSettingsFromUI() const
 		settings.testRotateMode = settingsDialog->getRotateMode();
 		settings.hrtfEnabled = settingsDialog->isHrtfEnabled();
 		settings.hrtfDataSet = settingsDialog->getHrtfDataSet();
+		settings.hrtfVoiceLimit = settingsDialog->getHrtfVoiceLimit();
 		settings.audioLoggingLevel = settingsDialog->getLoggingLevel();
 	}
 	return settings;
@@ -44,6 +44,7 @@ public:
 	UiAdapter( Interfaces::UseCaseFactory *useCaseFactory, Interfaces::ConfigFilePathSource *confPathSource, QObject *parent );
 
 	void showSettingsUi( const Entity::Settings &settings, const QStringList &hrtfDataNames, QWidget *parent );
+	void showStatistics( const QStringList &lines, QWidget *parent );
 
 private slots:
 	void onSettingsChanged();
@@ -40,6 +40,8 @@ VoiceChatAdapter::VoiceChatAdapter( Interfaces::VoiceChatDriver* driver, Interfa
 			 this,            SLOT(onSettingsUiRequested(QWidget*)) );
 	connect( driver->qtObj(), SIGNAL(pluginHelpRequested()),
 			 this,            SLOT(onPluginHelpRequested()) );
+	connect( driver->qtObj(), SIGNAL(statisticsRequested(QWidget*)),
+			 this,            SLOT(onStatisticsRequested(QWidget*)) );
 }
 
 quint16 VoiceChatAdapter::getMyUserId() const
@@ -87,4 +89,9 @@ void VoiceChatAdapter::onPluginHelpRequested()
 	useCaseFactory->showPluginHelp();
 }
 
+void VoiceChatAdapter::onStatisticsRequested( QWidget *parent )
+{
+	useCaseFactory->showStatistics( parent );
+}
+
 }
@@ -50,6 +50,7 @@ private slots:
 	void onPlaybackVolumeChanged();
 	void onSettingsUiRequested( QWidget *parent );
 	void onPluginHelpRequested();
+	void onStatisticsRequested( QWidget *parent );
 
 private:
 	Interfaces::VoiceChatDriver* driver;
@@ -24,6 +24,10 @@
 #include "../utils/logging.h"
 #include "../utils/wavfile.h"
 #include "../utils/async.h"
+#include "../utils/framequeue.h"
+#include "../utils/pcmconvert.h"
+#include "../utils/wakeupevent.h"
+#include "../utils/latency.h"
 #include "../openal/openal.h"
 #include "../openal/structures.h"
 
@@ -35,9 +39,17 @@
 #include <QVector>
 #include <QPointer>
 #include <QSet>
+#include <QList>
 #include <QFileSystemWatcher>
 #include <QMutex>
+#include <QTimer>
+#include <QThread>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QPair>
+#include <QtMath>
 
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 
@@ -45,9 +57,21 @@ namespace
 {
 QMutex mutex;
 
-const int AUDIO_FREQUENCY = 44100;
-const int SOURCE_ID_TEST = 1;
-const int SOURCE_ID_USER = 1000;
+// source ids index OpenAL's source table, so keep them small and dense,
+// users' sources follow the test source, one HRTF source for each voice slot
+// and then one panned source for each voice slot
+const int SOURCE_ID_TEST = 0;
+const int SOURCE_ID_USER = 1;
+const int VOICE_SLOT_COUNT = 32;
+const int SOURCE_ID_PANNED = SOURCE_ID_USER + VOICE_SLOT_COUNT;
+const int VOICE_QUEUE_CAPACITY = 8; // frames
+const int FEED_IDLE_INTERVAL = 100; // ms
+// voice level-of-detail, see updateVoicePriorities()
+const int PRIORITY_INTERVAL = 100; // ms
+const qreal ACTIVITY_DECAY = 2000; // ms
+const qreal REFERENCE_DISTANCE = 50; // meters
+const qreal PROMOTION_MARGIN = 1.5;
+const float LEVEL_SMOOTHING = 0.1f;
 
 QString getAppdataPath()
 {
@@ -62,6 +86,16 @@ QString getOALHRTFPath()
 	return QDir::cleanPath( targetPath );
 }
 
+/**
+ * Returns sampling rate of HRTF data set from its file name, e.g. 44100 from
+ * 'mit_kemar-44100.mhr', or 0 if the name has no rate.
+ */
+quint32 getHrtfDataSetSampleRate( const QString &name )
+{
+	QRegularExpressionMatch match = QRegularExpression( "-(\\d+)\\.mhr$" ).match( name );
+	return match.hasMatch()? match.captured( 1 ).toUInt() : 0;
+}
+
 ALfloat tsVolumeModifierToOALGain( float tsVolumeModifier )
 {
 	return 1.0 / ( pow( 2.0, tsVolumeModifier / -6.0 ) );
@@ -72,12 +106,77 @@ ALfloat tsVolumeModifierToOALGain( float tsVolumeModifier )
 namespace Driver
 {
 
+class OpenALBackendPrivate;
+
+/**
+ * Level-of-detail state of a voice slot, used only with the mutex locked.
+ *
+ * The slot's voice is played either in the HRTF source or, with HRTF
+ * bypassed, in the panned source. When the path changes one frame is played
+ * in both, fading out of the old and into the new.
+ */
+struct VoiceLod
+{
+	VoiceLod()
+		: hrtf( true ), renderedHrtf( true ), level( 0 ), lastVoiceTime( -1 ),
+		  leftGain( M_SQRT1_2 ), rightGain( M_SQRT1_2 )
+	{
+	}
+
+	// path chosen by ranking and path of the previous frame
+	bool hrtf;
+	bool renderedHrtf;
+	// smoothed mean amplitude of recent frames, in range [0, 1]
+	float level;
+	// time of the previous frame, -1 if none
+	qint64 lastVoiceTime;
+	// gains of the previous frame in the panned source
+	float leftGain;
+	float rightGain;
+};
+
+/**
+ * Voice frames of a single user, from TeamSpeak's audio thread to the feeder
+ * thread. The slot is free when its client id is -1.
+ */
+struct VoiceSlot
+{
+	VoiceSlot()
+		: clientId( -1 ), queue( VOICE_QUEUE_CAPACITY )
+	{
+	}
+
+	QAtomicInt clientId;
+	FrameQueue queue;
+};
+
+/**
+ * Thread which moves queued voice frames to OpenAL.
+ */
+class VoiceFeeder : public QThread
+{
+public:
+	VoiceFeeder( OpenALBackendPrivate *d )
+		: d( d )
+	{
+	}
+
+protected:
+	void run();
+
+private:
+	OpenALBackendPrivate *d;
+};
+
 class OpenALBackendPrivate
 {
 public:
 	OpenALBackendPrivate()
-		: isEnabled( false ), playbackVolume( 0 ), hrtfEnabled( false ), initNeeded( false )
+		: isEnabled( 0 ), playbackVolume( 0 ), hrtfEnabled( false ), hrtfSampleRate( 0 ), initNeeded( false ), feeder( this ),
+		  feedPending( 0 ), floatFormatSupported( -1 ), directChannelsSupported( -1 ), hrtfVoiceLimit( 0 ), lastPriorityTime( 0 ), flushTimer( NULL ),
+		  listenerDirty( false )
 	{
+		clock.start();
 	}
 
 	QStringList getResourceHrtfDataPaths() const
@@ -105,14 +204,387 @@ public:
 		return result;
 	}
 
-	OpenAL::OutputInfo getOutputInfo() const
+	const OpenAL::OutputInfo &getOutputInfo() const
 	{
-		return OpenAL::OutputInfo( playbackDeviceName, AUDIO_FREQUENCY, hrtfEnabled );
+		return outputInfo;
+	}
+
+	void updateOutputInfo()
+	{
+		outputInfo = OpenAL::OutputInfo( playbackDeviceName, getOutputSampleRate(), hrtfEnabled );
+	}
+
+	quint32 getOutputSampleRate() const
+	{
+		// OpenAL applies HRTF only if its data set has same rate as the
+		// output, so follow the data set if there's none at default rate
+		if( hrtfEnabled && hrtfSampleRate != 0 )
+		{
+			return hrtfSampleRate;
+		}
+		return OpenAL::OutputInfo::DEFAULT_SAMPLE_RATE;
+	}
+
+	/**
+	 * Returns variant of given HRTF data set which has same sampling rate as
+	 * the default output rate, or the data set itself if there is no such
+	 * variant.
+	 */
+	QString getPreferredHrtfDataSet( const QString &name ) const
+	{
+		QString fileName = QFileInfo( name ).fileName();
+		if( getHrtfDataSetSampleRate( fileName ) == OpenAL::OutputInfo::DEFAULT_SAMPLE_RATE )
+		{
+			return fileName;
+		}
+		QString variant = QString( fileName ).replace( QRegularExpression( "-\\d+\\.mhr$" ),
+			QString( "-%1.mhr" ).arg( OpenAL::OutputInfo::DEFAULT_SAMPLE_RATE ) );
+		foreach( QString path, getResourceHrtfDataPaths() )
+		{
+			if( QFileInfo( path ).fileName() == variant )
+			{
+				return variant;
+			}
+		}
+		return fileName;
 	}
 
 	OpenAL::SourceInfo getUserSourceInfo( quint16 userId ) const
 	{
-		return OpenAL::SourceInfo( getOutputInfo(), SOURCE_ID_USER + userId, switchHandness( userPositions[userId] ), 0, false, true );
+		// users without a voice slot have no source
+		int slotIndex = findVoiceSlotIndex( userId );
+		if( slotIndex == -1 )
+		{
+			return OpenAL::SourceInfo();
+		}
+		return OpenAL::SourceInfo( getOutputInfo(), SOURCE_ID_USER + slotIndex, switchHandness( userPositions[userId] ), 0, false, true );
+	}
+
+	OpenAL::SourceInfo getPannedSourceInfo( quint16 userId ) const
+	{
+		int slotIndex = findVoiceSlotIndex( userId );
+		if( slotIndex == -1 )
+		{
+			return OpenAL::SourceInfo();
+		}
+		// stereo audio in listener's space, panning is already mixed in
+		return OpenAL::SourceInfo( getOutputInfo(), SOURCE_ID_PANNED + slotIndex, Entity::Vector(), 0, true, true, true );
+	}
+
+	int findVoiceSlotIndex( quint16 id ) const
+	{
+		for( int i = 0; i < VOICE_SLOT_COUNT; i++ )
+		{
+			if( voiceSlots[i].clientId.loadAcquire() == id )
+			{
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	VoiceSlot *findVoiceSlot( quint16 id )
+	{
+		int slotIndex = findVoiceSlotIndex( id );
+		return slotIndex == -1? 0: &voiceSlots[slotIndex];
+	}
+
+	/**
+	 * Gives a voice slot to a new user. If all slots are taken the user
+	 * waits for one to be released.
+	 */
+	void assignVoiceSlot( quint16 id )
+	{
+		for( int i = 0; i < VOICE_SLOT_COUNT; i++ )
+		{
+			if( voiceSlots[i].clientId.loadAcquire() == -1 )
+			{
+				voiceLods[i] = VoiceLod();
+				voiceSlots[i].clientId.storeRelease( id );
+				return;
+			}
+		}
+		Log::warning() << "No free voice slot for user " << id << ", voice will not be positioned until a slot is released";
+		slotlessUsers.append( id );
+	}
+
+	void releaseVoiceSlot( quint16 id )
+	{
+		slotlessUsers.removeOne( id );
+		VoiceSlot *slot = findVoiceSlot( id );
+		if( slot )
+		{
+			slot->clientId.storeRelease( -1 );
+			if( !slotlessUsers.isEmpty() )
+			{
+				const quint16 waitingId = slotlessUsers.takeFirst();
+				Log::info() << "Voice slot released, positioning voice of user " << waitingId;
+				assignVoiceSlot( waitingId );
+			}
+		}
+	}
+
+	/**
+	 * Plays all queued voice frames, called from feeder thread.
+	 *
+	 * @returns true if any of the voice slots is in use
+	 */
+	bool feedVoiceFrames()
+	{
+		bool slotsInUse = false;
+		for( int i = 0; i < VOICE_SLOT_COUNT; i++ )
+		{
+			VoiceSlot &slot = voiceSlots[i];
+			const int clientId = slot.clientId.loadAcquire();
+			slotsInUse = slotsInUse || clientId != -1;
+			while( const FrameQueue::Frame *frame = slot.queue.front() )
+			{
+				// frames pushed before the slot was handed to another user are dropped
+				if( frame->clientId == clientId )
+				{
+					playVoiceFrame( *frame );
+				}
+				slot.queue.pop();
+			}
+		}
+		if( clock.elapsed() - lastPriorityTime >= PRIORITY_INTERVAL )
+		{
+			updateVoicePriorities();
+		}
+		return slotsInUse;
+	}
+
+	/**
+	 * Chooses which voices are positioned with HRTF, called from feeder
+	 * thread.
+	 *
+	 * Voices are ranked by their loudness and distance to the listener,
+	 * decayed by time since the user last spoke, and the top voices up to
+	 * the limit are given HRTF while the rest are panned. Current HRTF voices
+	 * are favoured by a margin so that similar voices don't trade places on
+	 * every ranking.
+	 */
+	void updateVoicePriorities()
+	{
+		QMutexLocker locker( &mutex );
+		const qint64 now = clock.elapsed();
+		lastPriorityTime = now;
+		QVector<QPair<qreal, int> > ranking;
+		ranking.reserve( VOICE_SLOT_COUNT );
+		for( int i = 0; i < VOICE_SLOT_COUNT; i++ )
+		{
+			const int clientId = voiceSlots[i].clientId.loadAcquire();
+			if( clientId == -1 )
+			{
+				continue;
+			}
+			const VoiceLod &lod = voiceLods[i];
+			// without direct channels the panned voice would go through
+			// HRTF anyway, so keep every voice on the HRTF path
+			if( !hrtfEnabled || hrtfVoiceLimit <= 0 || directChannelsSupported != 1 )
+			{
+				voiceLods[i].hrtf = true;
+				continue;
+			}
+			qreal score = 0;
+			if( lod.lastVoiceTime >= 0 )
+			{
+				const qreal distance = ( userPositions.value( clientId ) - cameraPosition ).getLength();
+				const qreal activity = qExp( -( now - lod.lastVoiceTime ) / ACTIVITY_DECAY );
+				score = lod.level * activity / ( 1 + distance / REFERENCE_DISTANCE );
+			}
+			if( lod.hrtf )
+			{
+				score *= PROMOTION_MARGIN;
+			}
+			// ties, e.g. voices which have not spoken, keep their path and
+			// then prefer lower slots
+			ranking.append( qMakePair( -score, ( lod.hrtf? 0: VOICE_SLOT_COUNT ) + i ) );
+		}
+		std::sort( ranking.begin(), ranking.end() );
+		for( int rank = 0; rank < ranking.size(); rank++ )
+		{
+			voiceLods[ranking[rank].second % VOICE_SLOT_COUNT].hrtf = rank < hrtfVoiceLimit;
+		}
+	}
+
+	/**
+	 * Returns constant power gains for panning user's voice by its direction
+	 * from the listener.
+	 */
+	void getPanGains( quint16 userId, float &leftGain, float &rightGain ) const
+	{
+		const Entity::Vector relative = userPositions.value( userId ) - cameraPosition;
+		const Entity::Vector right = cameraUp.crossProduct( cameraForward );
+		const qreal length = relative.getLength() * right.getLength();
+		const qreal pan = length > 0? qBound<qreal>( -1, relative.dotProduct( right ) / length, 1 ): 0;
+		const qreal angle = ( pan + 1 ) * M_PI / 4;
+		leftGain = qCos( angle );
+		rightGain = qSin( angle );
+	}
+
+	void playVoiceFrame( const FrameQueue::Frame &frame )
+	{
+		QMutexLocker locker( &mutex );
+		const int slotIndex = findVoiceSlotIndex( frame.clientId );
+		if( !userPositions.contains( frame.clientId ) || slotIndex == -1 )
+		{
+			return;
+		}
+		try
+		{
+			VoiceLod &lod = voiceLods[slotIndex];
+			const qint64 now = clock.elapsed();
+			// after a pause there's nothing playing to fade from
+			if( lod.lastVoiceTime < 0 || now - lod.lastVoiceTime > FEED_IDLE_INTERVAL )
+			{
+				lod.renderedHrtf = lod.hrtf;
+				getPanGains( frame.clientId, lod.leftGain, lod.rightGain );
+			}
+			lod.lastVoiceTime = now;
+			const bool switching = lod.hrtf != lod.renderedHrtf;
+			float leftGain = 0;
+			float rightGain = 0;
+			if( !lod.hrtf )
+			{
+				getPanGains( frame.clientId, leftGain, rightGain );
+			}
+			const float fromLeft = lod.renderedHrtf? 0: lod.leftGain;
+			const float fromRight = lod.renderedHrtf? 0: lod.rightGain;
+			const float fromHrtf = lod.renderedHrtf? 1: 0;
+			const float toHrtf = lod.hrtf? 1: 0;
+
+			// OpenAL positions only mono sources, so downmix the voice and
+			// pass it on as float if possible, sparing OpenAL a conversion,
+			// panned voice goes as stereo which bypasses HRTF
+			OpenAL::SourceInfo sourceInfo = getUserSourceInfo( frame.clientId );
+			if( floatFormatSupported == -1 )
+			{
+				floatFormatSupported = OpenAL::isFloatFormatSupported( sourceInfo.getOutputInfo() )? 1: 0;
+			}
+			if( directChannelsSupported == -1 )
+			{
+				directChannelsSupported = OpenAL::isDirectChannelsSupported( sourceInfo.getOutputInfo() )? 1: 0;
+			}
+			if( floatFormatSupported )
+			{
+				PcmConvert::downmixToFloat( frame.samples, frame.sampleCount, frame.channels, 1.0f, monoFloatSamples );
+				updateVoiceLevel( lod, monoFloatSamples, frame.sampleCount, 1.0f );
+				if( !lod.hrtf || switching )
+				{
+					PcmConvert::panToStereo( monoFloatSamples, frame.sampleCount, fromLeft, fromRight, leftGain, rightGain, stereoFloatSamples );
+				}
+				if( lod.hrtf || switching )
+				{
+					PcmConvert::rampGain( monoFloatSamples, frame.sampleCount, fromHrtf, toHrtf );
+				}
+				playVoice( lod, switching, sourceInfo,
+						   OpenAL::AudioData( 1, sizeof(float) * 8, frame.sampleCount * sizeof(float), 48000, monoFloatSamples ),
+						   getPannedSourceInfo( frame.clientId ),
+						   OpenAL::AudioData( 2, sizeof(float) * 8, frame.sampleCount * 2 * sizeof(float), 48000, stereoFloatSamples ) );
+			}
+			else
+			{
+				PcmConvert::downmixToInt16( frame.samples, frame.sampleCount, frame.channels, 1.0f, monoSamples );
+				updateVoiceLevel( lod, monoSamples, frame.sampleCount, 1.0f / 32768.0f );
+				if( !lod.hrtf || switching )
+				{
+					PcmConvert::panToStereo( monoSamples, frame.sampleCount, fromLeft, fromRight, leftGain, rightGain, stereoSamples );
+				}
+				if( lod.hrtf || switching )
+				{
+					PcmConvert::rampGain( monoSamples, frame.sampleCount, fromHrtf, toHrtf );
+				}
+				playVoice( lod, switching, sourceInfo,
+						   OpenAL::AudioData( 1, sizeof(short) * 8, frame.sampleCount * sizeof(short), 48000, monoSamples ),
+						   getPannedSourceInfo( frame.clientId ),
+						   OpenAL::AudioData( 2, sizeof(short) * 8, frame.sampleCount * 2 * sizeof(short), 48000, stereoSamples ) );
+			}
+			lod.renderedHrtf = lod.hrtf;
+			lod.leftGain = leftGain;
+			lod.rightGain = rightGain;
+		}
+		catch( const OpenAL::Failure &error )
+		{
+			Log::error() << "Failed to feed audio data to OpenAL, reason: " << error.what();
+		}
+	}
+
+	/**
+	 * Plays voice in its HRTF or panned source. While switching between the
+	 * two the source fading out is fed first and the source fading in is
+	 * synced to it, so that the fades meet.
+	 */
+	void playVoice( const VoiceLod &lod, bool switching,
+					const OpenAL::SourceInfo &hrtfSourceInfo, const OpenAL::AudioData &hrtfData,
+					const OpenAL::SourceInfo &pannedSourceInfo, const OpenAL::AudioData &pannedData )
+	{
+		if( !switching )
+		{
+			if( lod.hrtf )
+			{
+				OpenAL::playAudio( hrtfSourceInfo, hrtfData );
+			}
+			else
+			{
+				OpenAL::playAudio( pannedSourceInfo, pannedData );
+			}
+		}
+		else if( lod.hrtf )
+		{
+			OpenAL::playAudio( pannedSourceInfo, pannedData );
+			OpenAL::playAudio( hrtfSourceInfo, hrtfData, pannedSourceInfo );
+		}
+		else
+		{
+			OpenAL::playAudio( hrtfSourceInfo, hrtfData );
+			OpenAL::playAudio( pannedSourceInfo, pannedData, hrtfSourceInfo );
+		}
+	}
+
+	template <typename T>
+	void updateVoiceLevel( VoiceLod &lod, const T *samples, int sampleCount, float scale )
+	{
+		float sum = 0;
+		for( int i = 0; i < sampleCount; i++ )
+		{
+			sum += qAbs( samples[i] );
+		}
+		const float level = sampleCount > 0? sum * scale / sampleCount: 0;
+		lod.level += ( level - lod.level ) * LEVEL_SMOOTHING;
+	}
+
+	void stopFeeder()
+	{
+		feeder.requestInterruption();
+		feederWakeup.signal();
+		feeder.wait();
+		quint32 droppedCount = 0;
+		for( int i = 0; i < VOICE_SLOT_COUNT; i++ )
+		{
+			while( voiceSlots[i].queue.front() )
+			{
+				voiceSlots[i].queue.pop();
+			}
+			droppedCount += voiceSlots[i].queue.takeDroppedCount();
+		}
+		if( droppedCount > 0 )
+		{
+			Log::warning() << "Voice frames dropped due to full queues or oversized frames: " << QString::number( droppedCount );
+		}
+	}
+
+	void prepareUserSource( quint16 userId )
+	{
+		try
+		{
+			OpenAL::prepareSource( getUserSourceInfo( userId ) );
+			OpenAL::prepareSource( getPannedSourceInfo( userId ) );
+		}
+		catch( const OpenAL::Failure &error )
+		{
+			Log::error() << "Failed to prepare audio source, reason: " << error.what();
+		}
 	}
 
 	OpenAL::SourceInfo getTestSourceInfo() const
@@ -133,22 +605,72 @@ public:
 public:
 	QString dataPath;
 	QMap<quint16, Entity::Vector> userPositions;
-	bool isEnabled;
+	QAtomicInt isEnabled;
 	Entity::Vector cameraPosition;
 	Entity::Vector cameraForward;
 	Entity::Vector cameraUp;
 	Entity::Vector testSourcePosition;
 	QString playbackDeviceName;
+	OpenAL::OutputInfo outputInfo;
 	float playbackVolume;
 	bool hrtfEnabled;
+	quint32 hrtfSampleRate;
 	bool initNeeded;
+	VoiceSlot voiceSlots[VOICE_SLOT_COUNT];
+	// users without a voice slot, in order of arrival
+	QList<quint16> slotlessUsers;
+	VoiceFeeder feeder;
+	// set by the audio callback when it has queued frames, which are shared
+	// by all voice slots, the event is signalled only when the flag is set
+	// so that the callback makes at most one system call per feed
+	QAtomicInt feedPending;
+	WakeupEvent feederWakeup;
+	// voice converted to mono in feeder thread, -1 until float support is known
+	int floatFormatSupported;
+	// panned voice needs direct channels, -1 until their support is known
+	int directChannelsSupported;
+	float monoFloatSamples[FrameQueue::MAX_FRAME_SAMPLES];
+	short monoSamples[FrameQueue::MAX_FRAME_SAMPLES];
+	float stereoFloatSamples[FrameQueue::MAX_FRAME_SAMPLES * 2];
+	short stereoSamples[FrameQueue::MAX_FRAME_SAMPLES * 2];
+	// voice level-of-detail of each voice slot
+	VoiceLod voiceLods[VOICE_SLOT_COUNT];
+	int hrtfVoiceLimit;
+	QElapsedTimer clock;
+	qint64 lastPriorityTime;
+	// collects position changes of one game tick into single OpenAL update
+	QTimer *flushTimer;
+	QSet<quint16> dirtyUsers;
+	bool listenerDirty;
 };
 
+void VoiceFeeder::run()
+{
+	while( !isInterruptionRequested() )
+	{
+		// cleared before feeding so that a frame queued during the feed
+		// signals the event again
+		d->feedPending.storeRelease( 0 );
+		const bool slotsInUse = d->feedVoiceFrames();
+		// sleep until the audio callback hands over a frame, while voices
+		// are in use wake up regularly to keep their priorities up to date
+		if( !d->feedPending.loadAcquire() )
+		{
+			d->feederWakeup.wait( slotsInUse? PRIORITY_INTERVAL: -1 );
+		}
+	}
+}
+
 OpenALBackend::OpenALBackend( const QString &dataPath, QObject *parent )
 	: QObject( parent ), d_ptr( new OpenALBackendPrivate() )
 {
 	Q_D( OpenALBackend );
 	d->dataPath = dataPath;
+	d->updateOutputInfo();
+	d->flushTimer = new QTimer( this );
+	d->flushTimer->setSingleShot( true );
+	d->flushTimer->setInterval( 0 );
+	connect( d->flushTimer, SIGNAL(timeout()), this, SLOT(onFlushPositions()) );
 	// copy HRTF files from resources to location in file system where OpenAL
 	// will search them
 	foreach( QString entry, d->getResourceHrtfDataPaths() )
@@ -169,6 +691,7 @@ OpenALBackend::OpenALBackend( const QString &dataPath, QObject *parent )
 OpenALBackend::~OpenALBackend()
 {
 	Q_D( OpenALBackend );
+	d->stopFeeder();
 	delete d;
 }
 
@@ -176,14 +699,32 @@ void OpenALBackend::setEnabled( bool enabled )
 {
 	Q_D( OpenALBackend );
 	QMutexLocker locker( &mutex );
-	d->isEnabled = enabled;
+	if( enabled )
+	{
+		d->floatFormatSupported = -1;
+		d->directChannelsSupported = -1;
+		d->isEnabled.storeRelease( 1 );
+		d->feeder.start( QThread::HighPriority );
+		d->listenerDirty = true;
+		d->flushTimer->start();
+		foreach( quint16 id, d->userPositions.keys() )
+		{
+			d->prepareUserSource( id );
+		}
+	}
+	else
+	{
+		d->isEnabled.storeRelease( 0 );
+		// feeder takes the mutex while playing frames
+		locker.unlock();
+		d->stopFeeder();
+	}
 }
 
 bool OpenALBackend::isEnabled() const
 {
 	Q_D( const OpenALBackend );
-	QMutexLocker locker( &mutex );
-	return d->isEnabled;
+	return d->isEnabled.loadAcquire();
 }
 
 void OpenALBackend::removeUser( quint16 id )
@@ -192,7 +733,18 @@ void OpenALBackend::removeUser( quint16 id )
 	QMutexLocker locker( &mutex );
 	if( d->userPositions.contains( id ) )
 	{
+		try
+		{
+			OpenAL::releaseSource( d->getUserSourceInfo( id ) );
+			OpenAL::releaseSource( d->getPannedSourceInfo( id ) );
+		}
+		catch( const OpenAL::Failure &error )
+		{
+			Log::error() << "Failed to release audio source, reason: " << error.what();
+		}
 		d->userPositions.remove( id );
+		d->dirtyUsers.remove( id );
+		d->releaseVoiceSlot( id );
 	}
 }
 
@@ -200,7 +752,19 @@ void OpenALBackend::positionUser( quint16 id, const Entity::Vector &position )
 {
 	Q_D( OpenALBackend );
 	QMutexLocker locker( &mutex );
+	bool isNew = !d->userPositions.contains( id );
 	d->userPositions[id] = position;
+	if( isNew )
+	{
+		d->assignVoiceSlot( id );
+	}
+	if( isNew && d->isEnabled.load() )
+	{
+		// bind a source now so that user's first words don't wait for it
+		d->prepareUserSource( id );
+	}
+	d->dirtyUsers.insert( id );
+	d->flushTimer->start();
 }
 
 void OpenALBackend::positionCamera( const Entity::Vector &position, const Entity::Vector &forward, const Entity::Vector &up )
@@ -210,18 +774,16 @@ void OpenALBackend::positionCamera( const Entity::Vector &position, const Entity
 	d->cameraPosition = position;
 	d->cameraForward = forward;
 	d->cameraUp = up;
+	d->listenerDirty = true;
+	d->flushTimer->start();
+}
 
-	if( d->isEnabled )
-	{
-		try
-		{
-			OpenAL::updateListener( d->getListenerInfo() );
-		}
-		catch( const OpenAL::Failure &error )
-		{
-			Log::error() << "Failed to position camera, reason: " << error.what();
-		}
-	}
+void OpenALBackend::flush()
+{
+	Q_D( OpenALBackend );
+	// timer remains as fallback for changes given without a flush
+	d->flushTimer->stop();
+	onFlushPositions();
 }
 
 void OpenALBackend::setPlaybackDeviceName( const QString &name )
@@ -229,6 +791,7 @@ void OpenALBackend::setPlaybackDeviceName( const QString &name )
 	Q_D( OpenALBackend );
 	QMutexLocker locker( &mutex );
 	d->playbackDeviceName = name;
+	d->updateOutputInfo();
 }
 
 void OpenALBackend::setPlaybackVolume( float volume )
@@ -237,7 +800,7 @@ void OpenALBackend::setPlaybackVolume( float volume )
 	QMutexLocker locker( &mutex );
 	d->playbackVolume = volume;
 
-	if( d->isEnabled )
+	if( d->isEnabled.load() )
 	{
 		try
 		{
@@ -253,15 +816,27 @@ void OpenALBackend::setPlaybackVolume( float volume )
 void OpenALBackend::setHrtfEnabled( bool enabled )
 {
 	Q_D( OpenALBackend );
+	QMutexLocker locker( &mutex );
 	d->hrtfEnabled = enabled;
+	d->updateOutputInfo();
 }
 
 void OpenALBackend::setHrtfDataSet( const QString &name )
 {
 	Q_D( OpenALBackend );
-	if( OpenAL::setConfigValue( "hrtf_tables", name ) )
+	QString dataSet = d->getPreferredHrtfDataSet( name );
+	if( dataSet != QFileInfo( name ).fileName() )
+	{
+		Log::info() << "Using HRTF data set '" << dataSet << "' in place of '" << name << "'";
+	}
+	{
+		QMutexLocker locker( &mutex );
+		d->hrtfSampleRate = getHrtfDataSetSampleRate( dataSet );
+		d->updateOutputInfo();
+	}
+	if( OpenAL::setConfigValue( "hrtf_tables", dataSet ) )
 	{
-		if( d->isEnabled )
+		if( d->isEnabled.load() )
 		{
 			try
 			{
@@ -275,12 +850,19 @@ void OpenALBackend::setHrtfDataSet( const QString &name )
 	}
 }
 
+void OpenALBackend::setHrtfVoiceLimit( int limit )
+{
+	Q_D( OpenALBackend );
+	QMutexLocker locker( &mutex );
+	d->hrtfVoiceLimit = limit;
+}
+
 void OpenALBackend::setLoggingLevel( int level )
 {
 	Q_D( OpenALBackend );
 	if( OpenAL::setupLogging( level ) )
 	{
-		if( d->isEnabled )
+		if( d->isEnabled.load() )
 		{
 			try
 			{
@@ -308,7 +890,7 @@ QStringList OpenALBackend::getHrtfDataFileNames() const
 void OpenALBackend::playTestSound( const QString &filePath )
 {
 	Q_D( OpenALBackend );
-	if( d->isEnabled )
+	if( d->isEnabled.load() )
 	{
 		try
 		{
@@ -337,7 +919,7 @@ void OpenALBackend::positionTestSound( const Entity::Vector &position )
 {
 	Q_D( OpenALBackend );
 	d->testSourcePosition = position;
-	if( d->isEnabled )
+	if( d->isEnabled.load() )
 	{
 		try
 		{
@@ -353,7 +935,7 @@ void OpenALBackend::positionTestSound( const Entity::Vector &position )
 void OpenALBackend::stopTestSound()
 {
 	Q_D( OpenALBackend );
-	if( d->isEnabled )
+	if( d->isEnabled.load() )
 	{
 		try
 		{
@@ -366,26 +948,62 @@ void OpenALBackend::stopTestSound()
 	}
 }
 
-void OpenALBackend::onEditPlaybackVoiceDataEvent( quint16 id, short *samples, int sampleCount, int channels )
+void OpenALBackend::onFlushPositions()
 {
 	Q_D( OpenALBackend );
 	QMutexLocker locker( &mutex );
-	if( d->isEnabled && d->userPositions.contains( id ) )
+	if( d->isEnabled.load() && ( d->listenerDirty || !d->dirtyUsers.isEmpty() ) )
 	{
 		try
 		{
-			OpenAL::playAudio( d->getUserSourceInfo( id ),
-							   OpenAL::AudioData(
-								   channels,
-								   sizeof(short) * 8,
-								   channels * sampleCount * sizeof(short),
-								   48000,
-								   samples ) );
-			d->writeSilence( samples, sampleCount, channels );
+			// apply listener and source changes of the tick at once
+			OpenAL::beginUpdate( d->getOutputInfo() );
+			try
+			{
+				if( d->listenerDirty )
+				{
+					OpenAL::updateListener( d->getListenerInfo() );
+				}
+				foreach( quint16 id, d->dirtyUsers )
+				{
+					OpenAL::updateSource( d->getUserSourceInfo( id ) );
+				}
+			}
+			catch( ... )
+			{
+				OpenAL::commitUpdate();
+				throw;
+			}
+			OpenAL::commitUpdate();
+			Latency::markUpdateApplied();
 		}
 		catch( const OpenAL::Failure &error )
 		{
-			Log::error() << "Failed to feed audio data to OpenAL, reason: " << error.what();
+			Log::error() << "Failed to update positions, reason: " << error.what();
+		}
+	}
+	d->listenerDirty = false;
+	d->dirtyUsers.clear();
+}
+
+void OpenALBackend::onEditPlaybackVoiceDataEvent( quint16 id, short *samples, int sampleCount, int channels )
+{
+	Q_D( OpenALBackend );
+	// called from TeamSpeak's audio thread, only hand the frame over to the
+	// feeder thread without taking locks or calling into OpenAL
+	if( d->isEnabled.loadAcquire() )
+	{
+		VoiceSlot *slot = d->findVoiceSlot( id );
+		if( slot )
+		{
+			// a frame the queue rejects is counted as dropped, but silenced
+			// all the same so that the voice isn't heard unpositioned
+			slot->queue.push( id, samples, sampleCount, channels );
+			d->writeSilence( samples, sampleCount, channels );
+			if( d->feedPending.testAndSetRelease( 0, 1 ) )
+			{
+				d->feederWakeup.signal();
+			}
 		}
 	}
 }
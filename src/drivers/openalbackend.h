@@ -43,10 +43,12 @@ public:
 	void removeUser( quint16 id );
 	void positionUser( quint16 id, const Entity::Vector &position );
 	void positionCamera( const Entity::Vector &position, const Entity::Vector &forward, const Entity::Vector &up );
+	void flush();
 	void setPlaybackDeviceName( const QString &name );
 	void setPlaybackVolume( float volume );
 	void setHrtfEnabled( bool enabled );
 	void setHrtfDataSet( const QString &name );
+	void setHrtfVoiceLimit( int limit );
 	void setLoggingLevel( int level );
 	QStringList getHrtfDataFileNames() const;
 	void playTestSound( const QString &filePath );
@@ -56,6 +58,9 @@ public:
 	// from Interfaces::AudioSink
 	void onEditPlaybackVoiceDataEvent( quint16 id, short *samples, int sampleCount, int channels );
 
+private slots:
+	void onFlushPositions();
+
 private:
 	OpenALBackendPrivate *const d_ptr;
 	Q_DECLARE_PRIVATE( OpenALBackend )
@@ -21,6 +21,7 @@
 #include "teamspeakplugin.h"
 #include "../entities/enums.h"
 #include "../entities/failures.h"
+#include "../utils/latency.h"
 #include "config.h"
 
 #ifdef WIN32
@@ -32,6 +33,7 @@
 #include <iostream>
 #include <cassert>
 #include <functional>
+#include <limits>
 #include <teamspeak/public_errors.h>
 #include <ts3_functions.h>
 #include <QApplication>
@@ -149,8 +151,11 @@ LogLevel toTSLogLevel( Log::Severity severity )
 	return LogLevel_INFO;
 }
 
-typedef std::function<void()> OpFunc;
-typedef QList<OpFunc> OpFuncList;
+// number of possible TeamSpeak client ids
+const int CLIENT_ID_COUNT = 65536;
+// distance in meters a client must move relative to the listener before
+// its position is sent to TeamSpeak again
+const float POSITION_CHANGE_THRESHOLD = 0.01f;
 
 }
 
@@ -325,9 +330,10 @@ void ts3plugin_initMenus( PluginMenuItem*** menuItems, char** menuIcon )
 	 * e.g. for "test_plugin.dll", icon "1.png" is loaded from <TeamSpeak 3 Client install dir>\plugins\test_plugin\1.png
 	 */
 
-	BEGIN_CREATE_MENUS( 2 );  /* IMPORTANT: Number of menu items must be correct! */
-	CREATE_MENU_ITEM( PLUGIN_MENU_TYPE_GLOBAL, Entity::MENU_ID_GLOBAL_SETTINGS, "Settings" );
-	CREATE_MENU_ITEM( PLUGIN_MENU_TYPE_GLOBAL, Entity::MENU_ID_GLOBAL_HELP,     "Help" );
+	BEGIN_CREATE_MENUS( 3 );  /* IMPORTANT: Number of menu items must be correct! */
+	CREATE_MENU_ITEM( PLUGIN_MENU_TYPE_GLOBAL, Entity::MENU_ID_GLOBAL_SETTINGS,   "Settings" );
+	CREATE_MENU_ITEM( PLUGIN_MENU_TYPE_GLOBAL, Entity::MENU_ID_GLOBAL_STATISTICS, "Statistics" );
+	CREATE_MENU_ITEM( PLUGIN_MENU_TYPE_GLOBAL, Entity::MENU_ID_GLOBAL_HELP,       "Help" );
 	END_CREATE_MENUS;  /* Includes an assert checking if the number of menu items matched */
 
 	/*
@@ -406,6 +412,9 @@ void ts3plugin_onMenuItemEvent( uint64 serverConnectionHandlerID, PluginMenuType
 		case Entity::MENU_ID_GLOBAL_SETTINGS:
 			Driver::TeamSpeakPlugin::singleton()->showSettingsUi( getMainWindowWidget() );
 			break;
+		case Entity::MENU_ID_GLOBAL_STATISTICS:
+			Driver::TeamSpeakPlugin::singleton()->showStatistics( getMainWindowWidget() );
+			break;
 		case Entity::MENU_ID_GLOBAL_HELP:
 			Driver::TeamSpeakPlugin::singleton()->showPluginHelp();
 		default:
@@ -616,6 +625,11 @@ void TeamSpeakPlugin::showPluginHelp()
 	emit pluginHelpRequested();
 }
 
+void TeamSpeakPlugin::showStatistics( QWidget *parent )
+{
+	emit statisticsRequested( parent );
+}
+
 TeamSpeakAudioBackend *TeamSpeakPlugin::createAudioBackend()
 {
 	auto backend = new TeamSpeakAudioBackend( this );
@@ -746,32 +760,163 @@ uint64 TeamSpeakPlugin::getMyChannelID() const
 class TeamSpeakAudioBackendPrivate
 {
 public:
+	struct ClientOp
+	{
+		anyID id;
+		TS3_VECTOR position;
+	};
+
 	TeamSpeakAudioBackendPrivate()
-		: isEnabled( false ), testWaveHandle( 0 ), testSchandlerId( 0 )
+		: isEnabled( false ), testWaveHandle( 0 ), testSchandlerId( 0 ),
+		  indexById( CLIENT_ID_COUNT, -1 ), listenerOpPending( false ),
+		  isUpdatePending( false )
+	{
+	}
+
+	int getOrAddClient( quint16 id )
 	{
+		int index = indexById[id];
+		if( index == -1 )
+		{
+			index = clientIds.size();
+			indexById[id] = index;
+			clientIds.append( id );
+			for( int axis = 0; axis < 3; axis++ )
+			{
+				positions[axis].append( 0 );
+				relative[axis].append( 0 );
+				sent[axis].append( 0 );
+			}
+			changed.append( 0 );
+			// grows with clients so that updates never allocate
+			clientOps.reserve( clientIds.size() );
+			forceSend( index );
+		}
+		return index;
+	}
+
+	void removeClient( int index )
+	{
+		const int last = clientIds.size() - 1;
+		indexById[clientIds[index]] = -1;
+		if( index != last )
+		{
+			clientIds[index] = clientIds[last];
+			indexById[clientIds[index]] = index;
+			for( int axis = 0; axis < 3; axis++ )
+			{
+				positions[axis][index] = positions[axis][last];
+				sent[axis][index] = sent[axis][last];
+			}
+		}
+		clientIds.removeLast();
+		for( int axis = 0; axis < 3; axis++ )
+		{
+			positions[axis].removeLast();
+			relative[axis].removeLast();
+			sent[axis].removeLast();
+		}
+		changed.removeLast();
+	}
+
+	void setClientPosition( int index, const Entity::Vector &position )
+	{
+		positions[0][index] = position.x;
+		positions[1][index] = position.y;
+		positions[2][index] = position.z;
+	}
+
+	/**
+	 * Makes next update send client's position whether it changed or not.
+	 */
+	void forceSend( int index )
+	{
+		sent[0][index] = std::numeric_limits<float>::quiet_NaN();
+	}
+
+	/**
+	 * Transforms client positions in given range to listener space and
+	 * queues an op for each client which moved more than the threshold
+	 * relative to the listener since its position was last sent.
+	 */
+	void queueClientUpdates( int begin, int end )
+	{
+		const float cameraX = cameraPosition.x;
+		const float cameraY = cameraPosition.y;
+		const float cameraZ = cameraPosition.z;
+		const float *positionX = positions[0].constData();
+		const float *positionY = positions[1].constData();
+		const float *positionZ = positions[2].constData();
+		float *relativeX = relative[0].data();
+		float *relativeY = relative[1].data();
+		float *relativeZ = relative[2].data();
+		const float *sentX = sent[0].constData();
+		const float *sentY = sent[1].constData();
+		const float *sentZ = sent[2].constData();
+		quint8 *isChanged = changed.data();
+		// branchless so that the compiler can vectorize it, NaN in sent
+		// position compares as changed
+		for( int i = begin; i < end; i++ )
+		{
+			relativeX[i] = positionX[i] - cameraX;
+			relativeY[i] = positionY[i] - cameraY;
+			relativeZ[i] = positionZ[i] - cameraZ;
+			const float dx = relativeX[i] - sentX[i];
+			const float dy = relativeY[i] - sentY[i];
+			const float dz = relativeZ[i] - sentZ[i];
+			isChanged[i] = !( dx * dx + dy * dy + dz * dz <= POSITION_CHANGE_THRESHOLD * POSITION_CHANGE_THRESHOLD );
+		}
+		for( int i = begin; i < end; i++ )
+		{
+			if( isChanged[i] )
+			{
+				ClientOp op;
+				op.id = clientIds[i];
+				op.position.x = sent[0][i] = relativeX[i];
+				op.position.y = sent[1][i] = relativeY[i];
+				op.position.z = sent[2][i] = relativeZ[i];
+				clientOps.append( op );
+			}
+		}
 	}
 
-	OpFunc createTSCameraDirectionUpdate( const Entity::Vector &forward, const Entity::Vector &up ) const
+	void queueClientReset( quint16 id )
 	{
-		TS3_VECTOR tsPosition = {0, 0, 0};
-		TS3_VECTOR tsForward = toTSVector( forward );
-		TS3_VECTOR tsUp = toTSVector( up );
-		return [=] {
-			gTs3Functions.systemset3DListenerAttributes( gTs3Functions.getCurrentServerConnectionHandlerID(), &tsPosition, &tsForward, &tsUp );
-		};
+		ClientOp op;
+		op.id = id;
+		op.position.x = op.position.y = op.position.z = 0;
+		clientOps.append( op );
 	}
 
-	OpFunc createTSClientPositionUpdate( quint16 id, const Entity::Vector &position ) const
+	void queueListenerUpdate( const Entity::Vector &forward, const Entity::Vector &up )
 	{
-		TS3_VECTOR tsPosition = toTSVector( position );
-		return [=] {
-			gTs3Functions.channelset3DAttributes( gTs3Functions.getCurrentServerConnectionHandlerID(), id, &tsPosition );
-		};
+		listenerForward = toTSVector( forward );
+		listenerUp = toTSVector( up );
+		listenerOpPending = true;
 	}
 
-	Entity::Vector getClientRelativePosition( quint16 id ) const
+	/**
+	 * Executes queued ops. Called outside of locked mutex to avoid
+	 * deadlocks, ops are only queued and executed in main thread.
+	 */
+	void executeOps()
 	{
-		return clientPositions[id] - cameraPosition;
+		if( clientOps.isEmpty() && !listenerOpPending )
+		{
+			return;
+		}
+		const uint64 schandlerId = gTs3Functions.getCurrentServerConnectionHandlerID();
+		for( int i = 0; i < clientOps.size(); i++ )
+		{
+			gTs3Functions.channelset3DAttributes( schandlerId, clientOps[i].id, &clientOps[i].position );
+		}
+		if( listenerOpPending )
+		{
+			TS3_VECTOR tsPosition = {0, 0, 0};
+			gTs3Functions.systemset3DListenerAttributes( schandlerId, &tsPosition, &listenerForward, &listenerUp );
+		}
+		clientOps.resize( 0 );
+		listenerOpPending = false;
 	}
 
 	bool isConnectedToServer( uint64 schandlerId ) const
@@ -790,10 +935,28 @@ public:
 	Entity::Vector cameraPosition;
 	Entity::Vector cameraForward;
 	Entity::Vector cameraUp;
-	QMap<quint16, Entity::Vector> clientPositions;
 	bool isEnabled;
 	uint64 testWaveHandle;
 	uint64 testSchandlerId;
+
+	// index to client arrays for each client id, -1 if not positioned
+	QVector<qint32> indexById;
+	// clients packed to start of the arrays, per axis arrays of world
+	// positions, positions relative to the listener and positions last sent
+	// to TeamSpeak
+	QVector<quint16> clientIds;
+	QVector<float> positions[3];
+	QVector<float> relative[3];
+	QVector<float> sent[3];
+	QVector<quint8> changed;
+
+	// ops waiting for execution, capacity kept for all clients
+	QVector<ClientOp> clientOps;
+	bool listenerOpPending;
+	TS3_VECTOR listenerForward;
+	TS3_VECTOR listenerUp;
+	// true if positions have changed since previous flush
+	bool isUpdatePending;
 };
 
 TeamSpeakAudioBackend::TeamSpeakAudioBackend( QObject *parent )
@@ -814,7 +977,7 @@ void TeamSpeakAudioBackend::onCustom3dRolloffCalculationClientEvent( uint64 serv
 	Q_UNUSED( serverConnectionHandlerID );
 	Q_UNUSED( distance );
 	QMutexLocker locker( &audioBackendMutex );
-	if( d->isEnabled && gTs3Functions.getCurrentServerConnectionHandlerID() == serverConnectionHandlerID && d->clientPositions.contains( clientID ) )
+	if( d->isEnabled && gTs3Functions.getCurrentServerConnectionHandlerID() == serverConnectionHandlerID && d->indexById[clientID] != -1 )
 	{
 		*volume = 1.0;
 	}
@@ -836,32 +999,28 @@ void TeamSpeakAudioBackend::onCustom3dRolloffCalculationWaveEvent( uint64 server
 void TeamSpeakAudioBackend::setEnabled( bool enabled )
 {
 	Q_D( TeamSpeakAudioBackend );
-	OpFuncList ops;
 	{
 		QMutexLocker locker( &audioBackendMutex );
 		d->isEnabled = enabled;
 		if( enabled )
 		{
-			foreach( quint16 id, d->clientPositions.keys() )
+			for( int index = 0; index < d->clientIds.size(); index++ )
 			{
-				ops.append( d->createTSClientPositionUpdate( id, d->getClientRelativePosition( id ) ) );
+				d->forceSend( index );
 			}
-			ops.append( d->createTSCameraDirectionUpdate( d->cameraForward, d->cameraUp ) );
+			d->queueClientUpdates( 0, d->clientIds.size() );
+			d->queueListenerUpdate( d->cameraForward, d->cameraUp );
 		}
 		else
 		{
-			foreach( quint16 id, d->clientPositions.keys() )
+			foreach( quint16 id, d->clientIds )
 			{
-				ops.append( d->createTSClientPositionUpdate( id, Entity::Vector() ) );
+				d->queueClientReset( id );
 			}
-			ops.append( d->createTSCameraDirectionUpdate( Entity::Vector( 0, 0, 1 ), Entity::Vector( 0, 1, 0 ) ) );
+			d->queueListenerUpdate( Entity::Vector( 0, 0, 1 ), Entity::Vector( 0, 1, 0 ) );
 		}
 	}
-	// execute operations outside of locked mutex to avoid deadlocks
-	foreach( OpFunc op, ops )
-	{
-		op();
-	}
+	d->executeOps();
 }
 
 bool TeamSpeakAudioBackend::isEnabled() const
@@ -874,63 +1033,70 @@ void TeamSpeakAudioBackend::addUser( quint16 id )
 {
 	Q_D( TeamSpeakAudioBackend );
 	QMutexLocker locker( &audioBackendMutex );
-	d->clientPositions[id] = Entity::Vector();
+	d->setClientPosition( d->getOrAddClient( id ), Entity::Vector() );
 }
 
 void TeamSpeakAudioBackend::removeUser( quint16 id )
 {
 	Q_D( TeamSpeakAudioBackend );
-	OpFunc op = []{};
+	QMutexLocker locker( &audioBackendMutex );
+	const int index = d->indexById[id];
+	if( index != -1 )
 	{
-		QMutexLocker locker( &audioBackendMutex );
-		d->clientPositions.remove( id );
-		if( d->isEnabled )
-		{
-			op = d->createTSClientPositionUpdate( id, Entity::Vector() );
-		}
+		d->removeClient( index );
+	}
+	if( d->isEnabled )
+	{
+		d->queueClientReset( id );
 	}
-	// execute operation outside of locked mutex to avoid deadlocks
-	op();
 }
 
 void TeamSpeakAudioBackend::positionUser( quint16 id, const Entity::Vector &position )
 {
 	Q_D( TeamSpeakAudioBackend );
-	OpFunc op = []{};
+	QMutexLocker locker( &audioBackendMutex );
+	const int index = d->getOrAddClient( id );
+	d->setClientPosition( index, position );
+	if( d->isEnabled )
 	{
-		QMutexLocker locker( &audioBackendMutex );
-		d->clientPositions[id] = position;
-		if( d->isEnabled )
-		{
-			op = d->createTSClientPositionUpdate( id, d->getClientRelativePosition( id ) );
-		}
+		d->queueClientUpdates( index, index + 1 );
+		d->isUpdatePending = true;
 	}
-	// execute operation outside of locked mutex to avoid deadlocks
-	op();
 }
 
 void TeamSpeakAudioBackend::positionCamera( const Entity::Vector &position, const Entity::Vector &forward, const Entity::Vector &up )
 {
 	Q_D( TeamSpeakAudioBackend );
-	OpFuncList ops;
+	QMutexLocker locker( &audioBackendMutex );
+	d->cameraPosition = position;
+	if( d->isEnabled )
 	{
-		QMutexLocker locker( &audioBackendMutex );
-		d->cameraPosition = position;
-		d->cameraForward = forward;
-		d->cameraUp = up;
-		if( d->isEnabled )
+		// listener stays in origin, turning is left to TeamSpeak so that
+		// it does not move clients relative to the listener
+		d->queueClientUpdates( 0, d->clientIds.size() );
+		if( forward != d->cameraForward || up != d->cameraUp )
 		{
-			foreach( quint16 id, d->clientPositions.keys() )
-			{
-				ops.append( d->createTSClientPositionUpdate( id, d->getClientRelativePosition( id ) ) );
-			}
-			ops.append( d->createTSCameraDirectionUpdate( forward, up ) );
+			d->queueListenerUpdate( forward, up );
 		}
+		d->isUpdatePending = true;
+	}
+	d->cameraForward = forward;
+	d->cameraUp = up;
+}
+
+void TeamSpeakAudioBackend::flush()
+{
+	Q_D( TeamSpeakAudioBackend );
+	bool isApplied;
+	{
+		QMutexLocker locker( &audioBackendMutex );
+		isApplied = d->isUpdatePending;
+		d->isUpdatePending = false;
 	}
-	// execute operations outside of locked mutex to avoid deadlocks
-	foreach( OpFunc op, ops )
+	d->executeOps();
+	if( isApplied )
 	{
-		op();
+		Latency::markUpdateApplied();
 	}
 }
 
@@ -57,6 +57,7 @@ public:
 	QString getPluginDataPath() const;
 	void showSettingsUi( QWidget *parent );
 	void showPluginHelp();
+	void showStatistics( QWidget *parent );
 	TeamSpeakAudioBackend *createAudioBackend();
 
 signals:
@@ -66,6 +67,7 @@ signals:
 	void playbackVolumeChanged();
 	void settingsUiRequested( QWidget *parent );
 	void pluginHelpRequested();
+	void statisticsRequested( QWidget *parent );
 
 private slots:
 	void onCheckTimeout();
@@ -102,10 +104,12 @@ public:
 	void removeUser( quint16 id );
 	void positionUser( quint16 id, const Entity::Vector &position );
 	void positionCamera( const Entity::Vector &position, const Entity::Vector &forward, const Entity::Vector &up );
+	void flush();
 	void setPlaybackDeviceName( const QString &/*name*/ ) {}
 	void setPlaybackVolume( float /*volume*/ ) {}
 	void setHrtfEnabled( bool /*enabled*/ ) {}
 	void setHrtfDataSet( const QString &/*name*/ ) {}
+	void setHrtfVoiceLimit( int /*limit*/ ) {}
 	void setLoggingLevel( int /*level*/ ) {}
 	QStringList getHrtfDataFileNames() const { return QStringList(); }
 	void playTestSound( const QString &filePath );
@@ -19,20 +19,45 @@
  */
 
 #include "wotconnector.h"
+#include "wotsharedmemory.h"
+#include "wottrace.h"
 #include "../entities/vector.h"
+#include "../entities/gamestate.h"
 #include "../utils/logging.h"
+#include "../utils/namedevent.h"
+#include "../utils/latency.h"
 
 #include <QTimer>
+#include <QThread>
+#include <QAtomicInt>
 #include <QSharedMemory>
 #include <QDateTime>
 #include <iostream>
 #include <QIODevice>
 #include <QDataStream>
+#include <QVector>
+#include <QByteArray>
+#include <QtEndian>
+#include <cstddef>
+#include <atomic>
 
 namespace {
 
 const int TIME_LIMIT = 5;
-const quint8 PLUGIN_VERSION = 1;
+const int CONNECT_INTERVAL = 5000;
+// while data is stale, e.g. in garage, its timestamp is polled slowly to
+// notice when a battle starts
+const int IDLE_POLL_INTERVAL = 2000;
+// version 1 data has no notifications and must be polled
+const int POLL_INTERVAL = 100;
+// with notifications memory is read only to notice that the game has stopped
+// writing to it
+const int STALE_CHECK_INTERVAL = 1000;
+const int CLIENT_ID_COUNT = 0x10000;
+// copies of a block before giving up until next write, a retry is needed
+// only if the game writes twice during a copy
+const int MAX_READ_ATTEMPTS = 4;
+const char *const STATE_NAMES[] = { "detached", "idle", "in battle" };
 
 class MyDataStream : public QDataStream
 {
@@ -93,44 +118,81 @@ private:
 	qint64 memorySize;
 };
 
-struct PositionalAudioData
+quint16 toUInt16( const quint16 &value )
 {
-	PositionalAudioData()
-		: timestamp( 0 )
-	{
-	}
+	return qFromLittleEndian<quint16>( (const uchar*)&value );
+}
 
-	quint32 timestamp;
-	Entity::Vector cameraPosition;
-	Entity::Vector cameraDirection;
-	QMap<quint16, Entity::Vector> clientPositions;
-};
+quint32 toUInt32( const quint32 &value )
+{
+	return qFromLittleEndian<quint32>( (const uchar*)&value );
+}
+
+quint64 toUInt64( const quint64 &value )
+{
+	return qFromLittleEndian<quint64>( (const uchar*)&value );
+}
 
-QDataStream& operator>>( QDataStream &stream, Entity::Vector& vector )
+float toFloat( const float &value )
 {
-	float x, y, z;
-	stream >> x >> y >> z;
-	vector.x = x;
-	vector.y = y;
-	vector.z = z;
-	return stream;
+	const quint32 bits = qFromLittleEndian<quint32>( (const uchar*)&value );
+	float result;
+	memcpy( &result, &bits, sizeof( result ) );
+	return result;
 }
 
-QDataStream& operator>>( QDataStream &stream, PositionalAudioData& data )
+Entity::Vector toVector( const WotSharedMemory::Vector &vector )
 {
-	quint16 id;
-	Entity::Vector position;
-	quint8 clientCount;
-	stream >> data.timestamp
-		   >> data.cameraPosition
-		   >> data.cameraDirection
-		   >> clientCount;
-	for( int i = 0; i < clientCount; i++ )
-	{
-		stream >> id >> position;
-		data.clientPositions[id] = position;
-	}
-	return stream;
+	return Entity::Vector( toFloat( vector.x ), toFloat( vector.y ), toFloat( vector.z ) );
+}
+
+quint32 loadGeneration( const quint32 &generation )
+{
+	std::atomic_thread_fence( std::memory_order_acquire );
+	const quint32 value = *(const volatile quint32*)&generation;
+	std::atomic_thread_fence( std::memory_order_acquire );
+	return toUInt32( value );
+}
+
+bool isStale( quint32 timestamp )
+{
+	return ( QDateTime::currentDateTime().toTime_t() - timestamp ) > TIME_LIMIT;
+}
+
+const int CLIENTS_OFFSET = offsetof( WotSharedMemory::PositionalData, clients );
+
+/**
+ * Copies positional data to given snapshot, copying only clients which are
+ * in use. Returns amount of clients in the snapshot.
+ */
+int copyPositionalData( WotSharedMemory::PositionalData &snapshot, const WotSharedMemory::PositionalData *data, int size )
+{
+	memcpy( &snapshot, data, CLIENTS_OFFSET );
+	const int clientCount = qMin<int>( snapshot.clientCount, ( size - CLIENTS_OFFSET ) / sizeof( WotSharedMemory::ClientEntry ) );
+	memcpy( snapshot.clients, data->clients, clientCount * sizeof( WotSharedMemory::ClientEntry ) );
+	return clientCount;
+}
+
+/**
+ * Copies a version 3 record which starts with its generation, retrying if
+ * the game was writing it. Returns false if no consistent copy was taken.
+ */
+bool copyRecord( char *target, const char *source, int size )
+{
+	const quint32 &generation = *(const quint32*)source;
+	for( int attempt = 0; attempt < MAX_READ_ATTEMPTS; attempt++ )
+	{
+		const quint32 before = loadGeneration( generation );
+		if( before % 2 == 0 )
+		{
+			memcpy( target, source, size );
+			if( loadGeneration( generation ) == before )
+			{
+				return true;
+			}
+		}
+	}
+	return false;
 }
 
 }
@@ -138,18 +200,121 @@ QDataStream& operator>>( QDataStream &stream, PositionalAudioData& data )
 namespace Driver
 {
 
+class WotConnectorPrivate;
+
+/**
+ * Waits for the game to signal a write to the positional data and requests
+ * reading of the memory from connector's thread.
+ */
+class MemoryWaiter : public QThread
+{
+public:
+	MemoryWaiter( WotConnector *q, WotConnectorPrivate *d )
+		: q( q ), d( d )
+	{
+	}
+
+protected:
+	void run();
+
+private:
+	WotConnector *q;
+	WotConnectorPrivate *d;
+};
+
 class WotConnectorPrivate
 {
 public:
 	WotConnectorPrivate( WotConnector *q )
-		: memoryConnectTimer( new QTimer( q ) ), readMemoryTimer( new QTimer( q ) ),
-		  positionalDataMemory( new QSharedMemory( q ) ), pluginInfoMemory( new QSharedMemory( q ) )
+		: q( q ), memoryConnectTimer( new QTimer( q ) ), readMemoryTimer( new QTimer( q ) ),
+		  positionalDataMemory( new QSharedMemory( q ) ), pluginInfoMemory( new QSharedMemory( q ) ),
+		  notifyEvent( WotSharedMemory::POSITIONAL_DATA_EVENT_NAME ), waiter( q, this ), readPending( 0 ),
+		  state( WotConnector::Detached ), version( 0 ), rejectedVersion( 0 ), rejectedSize( -1 ), sequence( 0 ), timestamp( 0 ), writeTime( 0 ), readTime( 0 ), readCount( 0 ),
+		  slotByClientId( CLIENT_ID_COUNT, -1 ), memorySlotCount( 0 ), removedCount( 0 )
+	{
+		for( int i = 0; i < WotSharedMemory::MAX_CLIENT_SLOTS; i++ )
+		{
+			clients[i].used = false;
+			memorySlotGenerations[i] = 0;
+			memorySlotClientIds[i] = -1;
+		}
+		for( int i = 0; i < WotConnector::StateCount; i++ )
+		{
+			wakeupCounts[i] = 0;
+		}
+		changes.addedUsers.reserve( WotSharedMemory::MAX_CLIENT_SLOTS );
+		changes.removedUsers.reserve( WotSharedMemory::MAX_CLIENT_SLOTS );
+		changes.movedUsers.reserve( WotSharedMemory::MAX_CLIENT_SLOTS );
+	}
+
+	void startWaiter()
 	{
+		if( !waiter.isRunning() && notifyEvent.isValid() )
+		{
+			Log::info() << "Positional data notifications enabled";
+			waiter.start();
+		}
+	}
+
+	void stopWaiter()
+	{
+		waiter.requestInterruption();
+		notifyEvent.signal();
+		waiter.wait();
+	}
+
+	void setState( WotConnector::State newState )
+	{
+		if( newState == state )
+		{
+			return;
+		}
+		Log::info() << "Positional data state changed to " << STATE_NAMES[newState];
+		state = newState;
+		if( state == WotConnector::Detached )
+		{
+			readMemoryTimer->stop();
+			memoryConnectTimer->start();
+			return;
+		}
+		memoryConnectTimer->stop();
+		updateReadInterval();
+		readMemoryTimer->start();
+	}
+
+	void updateReadInterval()
+	{
+		if( state == WotConnector::AttachedIdle )
+		{
+			readMemoryTimer->setInterval( IDLE_POLL_INTERVAL );
+		}
+		else if( version == WotSharedMemory::POSITIONAL_DATA_V3 && waiter.isRunning() )
+		{
+			readMemoryTimer->setInterval( STALE_CHECK_INTERVAL );
+		}
+		else
+		{
+			readMemoryTimer->setInterval( POLL_INTERVAL );
+		}
+	}
+
+	/**
+	 * Returns timestamp of the data without reading rest of it. A timestamp
+	 * torn by a concurrent write only causes an extra read.
+	 */
+	quint32 peekTimestamp( quint8 version, const char *memory ) const
+	{
+		if( version == WotSharedMemory::POSITIONAL_DATA_V3 )
+		{
+			const WotSharedMemory::PositionalDataHeader *header = (const WotSharedMemory::PositionalDataHeader*)memory;
+			return toUInt32( ((const WotSharedMemory::SlottedPositionalData*)( header + 1 ))->camera.timestamp );
+		}
+		return toUInt32( ((const WotSharedMemory::PositionalData*)memory)->timestamp );
 	}
 
 	void writePluginInfo()
 	{
-		if ( pluginInfoMemory->create( sizeof( PLUGIN_VERSION ) ) == false )
+		if ( pluginInfoMemory->create( sizeof( WotSharedMemory::PLUGIN_VERSION ) ) == false )
 		{
 			Log::error() << "Failed to create shared memory for plugin info, reason: " << pluginInfoMemory->errorString();
 			return;
@@ -161,29 +326,358 @@ public:
 			return;
 		}
 		MyDataStream stream( &buffer );
-		stream << PLUGIN_VERSION;
+		stream << WotSharedMemory::PLUGIN_VERSION;
+	}
+
+	void updateCamera( const Entity::Vector &position, const Entity::Vector &direction )
+	{
+		if( position != cameraPosition || direction != cameraDirection )
+		{
+			cameraPosition = position;
+			cameraDirection = direction;
+			changes.cameraChanged = true;
+			changes.cameraPosition = position;
+			changes.cameraDirection = direction;
+		}
+	}
+
+	/**
+	 * Adds client if it is new or moves it if its position has changed.
+	 * Returns index of the client in clients or -1 if there is no room.
+	 */
+	int updateClient( quint16 id, const Entity::Vector &position )
+	{
+		int slot = slotByClientId[id];
+		if( slot == -1 )
+		{
+			for( slot = 0; slot < WotSharedMemory::MAX_CLIENT_SLOTS && clients[slot].used; slot++ );
+			if( slot == WotSharedMemory::MAX_CLIENT_SLOTS )
+			{
+				return -1;
+			}
+			clients[slot].used = true;
+			clients[slot].id = id;
+			clients[slot].position = position;
+			clients[slot].memorySlot = -1;
+			slotByClientId[id] = slot;
+			changes.addedUsers.append( id );
+			addMovedClient( id, position );
+		}
+		else if( clients[slot].position != position )
+		{
+			clients[slot].position = position;
+			addMovedClient( id, position );
+		}
+		return slot;
+	}
+
+	void removeClient( int slot )
+	{
+		const quint16 id = clients[slot].id;
+		clients[slot].used = false;
+		slotByClientId[id] = -1;
+		changes.removedUsers.append( id );
+	}
+
+	void addMovedClient( quint16 id, const Entity::Vector &position )
+	{
+		Entity::UserPosition user;
+		user.id = id;
+		user.position = position;
+		changes.movedUsers.append( user );
+	}
+
+	/**
+	 * Emits changes collected during a read as one state.
+	 */
+	void emitState()
+	{
+		if( !changes.isEmpty() )
+		{
+			changes.writeTime = writeTime;
+			changes.readTime = readTime;
+			emit q->gameStateChanged( changes );
+			changes.clear();
+		}
 	}
 
+	/**
+	 * Removes all clients and forgets what was read from version 3 slots so
+	 * that the slots are read again in full.
+	 */
+	void resetClients()
+	{
+		for( int slot = 0; slot < WotSharedMemory::MAX_CLIENT_SLOTS; slot++ )
+		{
+			if( clients[slot].used )
+			{
+				removeClient( slot );
+			}
+			memorySlotGenerations[slot] = 0;
+			memorySlotClientIds[slot] = -1;
+		}
+		memorySlotCount = 0;
+	}
+
+	/**
+	 * Reads version 1 data.
+	 */
+	void readBlock( const char *memory, int size )
+	{
+		int clientCount = copyPositionalData( snapshot, (const WotSharedMemory::PositionalData*)memory, size );
+		timestamp = toUInt32( snapshot.timestamp );
+		writeTime = 0;
+		if( isStale( timestamp ) )
+		{
+			updateCamera( Entity::Vector(), Entity::Vector() );
+			clientCount = 0;
+		}
+		else
+		{
+			updateCamera( toVector( snapshot.cameraPosition ), toVector( snapshot.cameraDirection ) );
+		}
+
+		readCount++;
+		for( int i = 0; i < clientCount; i++ )
+		{
+			const int slot = updateClient( toUInt16( snapshot.clients[i].id ), toVector( snapshot.clients[i].position ) );
+			if( slot != -1 )
+			{
+				clients[slot].lastSeen = readCount;
+			}
+		}
+		for( int slot = 0; slot < WotSharedMemory::MAX_CLIENT_SLOTS; slot++ )
+		{
+			if( clients[slot].used && clients[slot].lastSeen != readCount )
+			{
+				removeClient( slot );
+			}
+		}
+	}
+
+	/**
+	 * Copies the memory to be recorded, retrying version 3 records like when
+	 * reading them so that the trace holds no torn records. Version 1 data
+	 * has no protection and is copied as is. Returns false if a consistent
+	 * copy could not be taken.
+	 */
+	bool copyForRecording( quint8 version, const char *memory, int size )
+	{
+		recordCopy.resize( size );
+		char *copy = recordCopy.data();
+		memcpy( copy, memory, size );
+		if( version != WotSharedMemory::POSITIONAL_DATA_V3 )
+		{
+			return true;
+		}
+		const int offset = sizeof( WotSharedMemory::PositionalDataHeader );
+		const WotSharedMemory::SlottedPositionalData *data = (const WotSharedMemory::SlottedPositionalData*)( memory + offset );
+		WotSharedMemory::SlottedPositionalData *copied = (WotSharedMemory::SlottedPositionalData*)( copy + offset );
+		if( !copyRecord( (char*)&copied->camera, (const char*)&data->camera, sizeof( data->camera ) ) )
+		{
+			return false;
+		}
+		const int slotCount = qMin<int>( toUInt16( copied->camera.slotCount ), WotSharedMemory::MAX_CLIENT_SLOTS );
+		for( int memorySlot = 0; memorySlot < slotCount; memorySlot++ )
+		{
+			if( !copyRecord( (char*)&copied->clientSlots[memorySlot], (const char*)&data->clientSlots[memorySlot], sizeof( WotSharedMemory::ClientSlot ) ) )
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * Reads version 3 data, touching only slots which have changed since
+	 * previous read. Returns false if some record was being written and must
+	 * be read again.
+	 */
+	bool readSlots( const char *memory )
+	{
+		const WotSharedMemory::SlottedPositionalData *data = (const WotSharedMemory::SlottedPositionalData*)( memory + sizeof( WotSharedMemory::PositionalDataHeader ) );
+
+		WotSharedMemory::CameraRecord camera;
+		bool isConsistent = false;
+		for( int attempt = 0; attempt < MAX_READ_ATTEMPTS && !isConsistent; attempt++ )
+		{
+			const quint32 generation = loadGeneration( data->camera.generation );
+			if( generation % 2 == 0 )
+			{
+				memcpy( &camera, &data->camera, sizeof( camera ) );
+				isConsistent = loadGeneration( data->camera.generation ) == generation;
+			}
+		}
+		if( !isConsistent )
+		{
+			return false;
+		}
+
+		timestamp = toUInt32( camera.timestamp );
+		const qint64 cameraWriteTime = toUInt64( camera.writeTime );
+		if( cameraWriteTime != 0 && cameraWriteTime != writeTime )
+		{
+			Latency::record( Latency::WriteToRead, readTime - cameraWriteTime );
+		}
+		writeTime = cameraWriteTime;
+		if( isStale( timestamp ) )
+		{
+			updateCamera( Entity::Vector(), Entity::Vector() );
+			resetClients();
+			return true;
+		}
+		updateCamera( toVector( camera.position ), toVector( camera.direction ) );
+
+		const int slotCount = qMin<int>( toUInt16( camera.slotCount ), WotSharedMemory::MAX_CLIENT_SLOTS );
+		const int checkedSlotCount = qMax( slotCount, memorySlotCount );
+		bool isComplete = true;
+		removedCount = 0;
+		for( int memorySlot = 0; memorySlot < checkedSlotCount; memorySlot++ )
+		{
+			WotSharedMemory::ClientSlot record;
+			record.used = 0;
+			if( memorySlot < slotCount )
+			{
+				const WotSharedMemory::ClientSlot &source = data->clientSlots[memorySlot];
+				const quint32 generation = loadGeneration( source.generation );
+				if( generation == memorySlotGenerations[memorySlot] )
+				{
+					continue;
+				}
+				if( generation % 2 != 0 )
+				{
+					isComplete = false;
+					continue;
+				}
+				memcpy( &record, &source, sizeof( record ) );
+				if( loadGeneration( source.generation ) != generation )
+				{
+					isComplete = false;
+					continue;
+				}
+				memorySlotGenerations[memorySlot] = generation;
+			}
+			else
+			{
+				memorySlotGenerations[memorySlot] = 0;
+			}
+
+			const int previousId = memorySlotClientIds[memorySlot];
+			const int id = record.used? toUInt16( record.id ): -1;
+			if( previousId != -1 && previousId != id )
+			{
+				// removed later unless the client moved to another slot
+				const int slot = slotByClientId[previousId];
+				if( slot != -1 && clients[slot].memorySlot == memorySlot )
+				{
+					clients[slot].memorySlot = -1;
+					removedSlots[removedCount++] = slot;
+				}
+			}
+			memorySlotClientIds[memorySlot] = id;
+			if( id != -1 )
+			{
+				const int slot = updateClient( id, toVector( record.position ) );
+				if( slot != -1 )
+				{
+					clients[slot].memorySlot = memorySlot;
+				}
+			}
+		}
+		memorySlotCount = slotCount;
+		for( int i = 0; i < removedCount; i++ )
+		{
+			const int slot = removedSlots[i];
+			if( clients[slot].used && clients[slot].memorySlot == -1 )
+			{
+				removeClient( slot );
+			}
+		}
+		return isComplete;
+	}
+
+	WotConnector *q;
 	QTimer* memoryConnectTimer;
 	QTimer* readMemoryTimer;
 	QSharedMemory* positionalDataMemory;
 	QSharedMemory* pluginInfoMemory;
-	MemoryAreaBuffer* memoryBuffer;
-	PositionalAudioData previousData;
+	NamedEvent notifyEvent;
+	MemoryWaiter waiter;
+	// set while a read requested by the waiter is queued
+	QAtomicInt readPending;
+	WotConnector::State state;
+	quint32 wakeupCounts[WotConnector::StateCount];
+
+	// state of previous read, diffed against the memory on each read
+	struct ClientSlot
+	{
+		quint16 id;
+		Entity::Vector position;
+		// value of readCount when the client was last in version 1 or 2 data
+		quint32 lastSeen;
+		// slot of the client in version 3 data, -1 if none
+		int memorySlot;
+		bool used;
+	};
+	quint8 version;
+	// version and size of memory which could not be read, logged only when
+	// they change, size is -1 if memory was read
+	quint8 rejectedVersion;
+	int rejectedSize;
+	quint32 sequence;
+	quint32 timestamp;
+	// monotonic times of the game's latest write and of current read
+	qint64 writeTime;
+	qint64 readTime;
+	quint32 readCount;
+	// copy of version 1 data, taken before it is compared
+	WotSharedMemory::PositionalData snapshot;
+	Entity::Vector cameraPosition;
+	Entity::Vector cameraDirection;
+	// changes since previous emit, reused between reads
+	Entity::GameState changes;
+	// records read memory to a trace file if path is set
+	QString recordFilePath;
+	WotTraceWriter recorder;
+	// consistent copy of the memory, written to the trace
+	QByteArray recordCopy;
+	ClientSlot clients[WotSharedMemory::MAX_CLIENT_SLOTS];
+	// index to clients for each client id, -1 if not in the memory
+	QVector<qint16> slotByClientId;
+	// generation and client id of each version 3 slot at previous read
+	quint32 memorySlotGenerations[WotSharedMemory::MAX_CLIENT_SLOTS];
+	int memorySlotClientIds[WotSharedMemory::MAX_CLIENT_SLOTS];
+	int memorySlotCount;
+	// clients which left their version 3 slot during a read
+	int removedSlots[WotSharedMemory::MAX_CLIENT_SLOTS];
+	int removedCount;
 };
 
+void MemoryWaiter::run()
+{
+	// sleeps until the game writes, stopWaiter() signals the event to wake
+	// the thread up for exit
+	while( !isInterruptionRequested() )
+	{
+		if( d->notifyEvent.wait( -1 ) && d->readPending.testAndSetOrdered( 0, 1 ) )
+		{
+			QMetaObject::invokeMethod( q, "readMemory", Qt::QueuedConnection );
+		}
+	}
+}
+
 WotConnector::WotConnector( QObject *parent )
 	: QObject( parent ), d_ptr( new WotConnectorPrivate( this ) )
 {
 	Q_D( WotConnector );
 	connect( d->memoryConnectTimer, SIGNAL(timeout()), this, SLOT(connectToMemory()) );
-	d->memoryConnectTimer->setInterval( 5000 );
+	d->memoryConnectTimer->setInterval( CONNECT_INTERVAL );
 	d->memoryConnectTimer->setSingleShot( false );
 	connect( d->readMemoryTimer, SIGNAL(timeout()), this, SLOT(readMemory()) );
-	d->readMemoryTimer->setInterval( 100 );
+	d->readMemoryTimer->setInterval( POLL_INTERVAL );
 	d->readMemoryTimer->setSingleShot( false );
-	d->positionalDataMemory->setNativeKey( "TessuModTSPlugin3dAudio" );
-	d->pluginInfoMemory->setNativeKey( "TessuModTSPluginInfo" );
+	d->positionalDataMemory->setNativeKey( WotSharedMemory::POSITIONAL_DATA_KEY );
+	d->pluginInfoMemory->setNativeKey( WotSharedMemory::PLUGIN_INFO_KEY );
 }
 
 WotConnector::~WotConnector()
@@ -191,14 +685,50 @@ WotConnector::~WotConnector()
 	Q_D( WotConnector );
 	d->memoryConnectTimer->stop();
 	d->readMemoryTimer->stop();
+	d->stopWaiter();
 	delete d;
 }
 
 void WotConnector::initialize()
 {
 	Q_D( WotConnector );
-	d->memoryConnectTimer->start();
 	d->writePluginInfo();
+	if( !d->notifyEvent.create() )
+	{
+		Log::error() << "Failed to create positional data notify event, reason: " << d->notifyEvent.errorString();
+	}
+	d->memoryConnectTimer->start();
+	connectToMemory();
+}
+
+WotConnector::State WotConnector::getState() const
+{
+	Q_D( const WotConnector );
+	return d->state;
+}
+
+quint32 WotConnector::getWakeupCount( State state ) const
+{
+	Q_D( const WotConnector );
+	return d->wakeupCounts[state];
+}
+
+QStringList WotConnector::getStatistics() const
+{
+	Q_D( const WotConnector );
+	QStringList lines;
+	lines.append( QString( "Positional data state: " ) + STATE_NAMES[d->state] );
+	for( int state = 0; state < StateCount; state++ )
+	{
+		lines.append( QString( "Wakeups while " ) + STATE_NAMES[state] + ": " + QString::number( d->wakeupCounts[state] ) );
+	}
+	return lines;
+}
+
+void WotConnector::setRecordFilePath( const QString &filePath )
+{
+	Q_D( WotConnector );
+	d->recordFilePath = filePath;
 }
 
 QObject *WotConnector::qtObj()
@@ -209,6 +739,7 @@ QObject *WotConnector::qtObj()
 void WotConnector::connectToMemory()
 {
 	Q_D( WotConnector );
+	d->wakeupCounts[Detached]++;
 	if ( d->positionalDataMemory->attach( QSharedMemory::ReadOnly ) == false )
 	{
 		if ( d->positionalDataMemory->error() != QSharedMemory::NotFound )
@@ -217,64 +748,121 @@ void WotConnector::connectToMemory()
 		}
 		return;
 	}
-	d->memoryBuffer = new MemoryAreaBuffer( d->positionalDataMemory, this );
-	if ( d->memoryBuffer->open( QIODevice::ReadOnly ) == false )
-	{
-		Log::error() << "Failed to open buffer";
-		return;
-	}
-	d->memoryConnectTimer->stop();
-	d->readMemoryTimer->start();
+	d->setState( AttachedIdle );
+	readMemory();
 }
 
 void WotConnector::readMemory()
 {
 	Q_D( WotConnector );
-	d->memoryBuffer->seek( 0 );
-	MyDataStream stream( d->memoryBuffer );
-	PositionalAudioData data;
-	stream >> data;
+	// cleared before reading so that a write during the read is not missed
+	d->readPending.store( 0 );
+	d->wakeupCounts[d->state]++;
+	d->readTime = Latency::now();
 
-	if( ( QDateTime::currentDateTime().toTime_t() - data.timestamp ) > TIME_LIMIT )
+	const char *memory = (const char*)d->positionalDataMemory->constData();
+	const int size = d->positionalDataMemory->size();
+	quint8 version = WotSharedMemory::POSITIONAL_DATA_V1;
+	quint32 sequence = 0;
+	const WotSharedMemory::PositionalDataHeader *header = (const WotSharedMemory::PositionalDataHeader*)memory;
+	if( size >= (int)sizeof( *header ) && toUInt32( header->magic ) == WotSharedMemory::POSITIONAL_DATA_MAGIC )
 	{
-		data.cameraPosition = Entity::Vector();
-		data.cameraDirection = Entity::Vector();
-		data.clientPositions.clear();
+		version = header->version;
+		sequence = loadGeneration( header->sequence );
 	}
-
-	if( data.cameraPosition != d->previousData.cameraPosition )
+	int requiredSize = 0;
+	if( version == WotSharedMemory::POSITIONAL_DATA_V1 )
 	{
-		emit gameCameraPositionChanged( data.cameraPosition );
+		requiredSize = CLIENTS_OFFSET;
 	}
-	if( data.cameraDirection != d->previousData.cameraDirection )
+	else if( version == WotSharedMemory::POSITIONAL_DATA_V3 )
 	{
-		emit gameCameraDirectionChanged( data.cameraDirection );
+		requiredSize = sizeof( *header ) + sizeof( WotSharedMemory::SlottedPositionalData );
 	}
-	foreach( quint16 id, data.clientPositions.keys() )
+	// unknown version
+	if( requiredSize == 0 || size < requiredSize )
 	{
-		Entity::Vector pos = data.clientPositions[id];
-		if ( d->previousData.clientPositions.contains( id ) )
+		if( version != d->rejectedVersion || size != d->rejectedSize )
 		{
-			if ( d->previousData.clientPositions[id] != pos )
-			{
-				emit gameUserPositionChanged( id, pos );
-			}
+			Log::warning() << "Unsupported positional data, version: " << quint16( version ) << ", size: " << QString::number( size );
+			d->rejectedVersion = version;
+			d->rejectedSize = size;
 		}
-		else
+		return;
+	}
+	d->rejectedSize = -1;
+
+	const bool isVersionChanged = version != d->version;
+	if( isVersionChanged )
+	{
+		d->resetClients();
+		if( version == WotSharedMemory::POSITIONAL_DATA_V3 )
 		{
-			emit gameUserAdded( id );
-			emit gameUserPositionChanged( id, pos );
+			d->startWaiter();
 		}
+		d->version = version;
+		d->updateReadInterval();
+	}
+
+	if( d->state == AttachedIdle )
+	{
+		// no diffing until the game starts writing fresh data
+		const quint32 timestamp = d->peekTimestamp( version, memory );
+		if( !isVersionChanged && timestamp == d->timestamp )
+		{
+			return;
+		}
+		d->timestamp = timestamp;
+		if( isStale( timestamp ) )
+		{
+			return;
+		}
+		d->setState( InBattle );
+	}
+	else if( !isVersionChanged && version == WotSharedMemory::POSITIONAL_DATA_V3 && sequence == d->sequence && !isStale( d->timestamp ) )
+	{
+		// nothing written since previous read
+		return;
+	}
+
+	bool isComplete = true;
+	if( version == WotSharedMemory::POSITIONAL_DATA_V3 )
+	{
+		isComplete = d->readSlots( memory );
 	}
-	foreach( quint16 id, d->previousData.clientPositions.keys() )
+	else
 	{
-		if ( !data.clientPositions.contains( id ) )
+		d->readBlock( memory, size );
+	}
+	// read again on next wakeup if the game was writing during this read
+	d->sequence = isComplete? sequence: sequence - 1;
+	d->emitState();
+
+	if( !d->recordFilePath.isEmpty() )
+	{
+		if( !d->recorder.isOpen() )
 		{
-			emit gameUserRemoved( id );
+			if( !d->recorder.open( d->recordFilePath, size ) )
+			{
+				Log::error() << "Failed to open positional data trace " << d->recordFilePath << " for recording, reason: " << d->recorder.errorString();
+				d->recordFilePath.clear();
+			}
+			else
+			{
+				Log::info() << "Recording positional data to " << d->recordFilePath;
+			}
+		}
+		// a torn read is read again, record only what was read whole
+		if( d->recorder.isOpen() && isComplete && d->copyForRecording( version, memory, size ) )
+		{
+			d->recorder.write( d->recordCopy.constData() );
 		}
 	}
 
-	d->previousData = data;
+	if( isStale( d->timestamp ) )
+	{
+		d->setState( AttachedIdle );
+	}
 }
 
 }
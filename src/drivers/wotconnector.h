@@ -21,6 +21,7 @@
 #pragma once
 
 #include <QObject>
+#include <QStringList>
 #include "../interfaces/drivers.h"
 
 class QTimer;
@@ -28,7 +29,7 @@ class QSharedMemory;
 
 namespace Entity
 {
-class Vector;
+class GameState;
 }
 
 namespace Driver
@@ -40,20 +41,45 @@ class WotConnector : public QObject, public Interfaces::GameDataDriver
 	Q_OBJECT
 
 public:
+	/**
+	 * Attachment to positional data memory. While detached the connector
+	 * tries to attach now and then, while idle the data is stale and only
+	 * its timestamp is polled slowly, and in battle the data is read on each
+	 * write, or polled quickly if the game does not notify of writes.
+	 */
+	enum State
+	{
+		Detached,
+		AttachedIdle,
+		InBattle,
+		StateCount
+	};
+
 	WotConnector( QObject *parent );
 	~WotConnector();
 
 	void initialize();
 
+	State getState() const;
+
+	/**
+	 * Returns how many times the connector has woken up to check the memory
+	 * while in given state.
+	 */
+	quint32 getWakeupCount( State state ) const;
+
+	/**
+	 * Records each distinct content of positional data memory to given
+	 * file, for playing back with WotReplay.
+	 */
+	void setRecordFilePath( const QString &filePath );
+
 	// from Interfaces::GameDataDriver
 	QObject *qtObj();
+	QStringList getStatistics() const;
 
 signals:
-	void gameUserAdded( quint16 id );
-	void gameUserRemoved( quint16 id );
-	void gameUserPositionChanged( quint16 id, const Entity::Vector &position );
-	void gameCameraPositionChanged( const Entity::Vector &position );
-	void gameCameraDirectionChanged( const Entity::Vector &direction );
+	void gameStateChanged( const Entity::GameState &state );
 
 private slots:
 	void connectToMemory();
@@ -0,0 +1,187 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include "wotreplay.h"
+#include "wotsharedmemory.h"
+#include "wottrace.h"
+#include "../utils/logging.h"
+#include "../utils/namedevent.h"
+#include "../utils/latency.h"
+
+#include <QTimer>
+#include <QSharedMemory>
+#include <QtEndian>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QByteArray>
+#include <cstring>
+
+namespace {
+
+/**
+ * Moves little endian timestamp so that it is as old now as it was at given
+ * time of recording.
+ */
+void shiftTimestamp( quint32 &timestamp, quint32 recordTime, quint32 now )
+{
+	const quint32 age = recordTime - qFromLittleEndian<quint32>( timestamp );
+	timestamp = qToLittleEndian<quint32>( now - age );
+}
+
+}
+
+namespace Driver
+{
+
+class WotReplayPrivate
+{
+public:
+	WotReplayPrivate( WotReplay *q )
+		: writeTimer( new QTimer( q ) ), memory( new QSharedMemory( q ) ),
+		  notifyEvent( WotSharedMemory::POSITIONAL_DATA_EVENT_NAME ), fast( false ),
+		  frameCount( 0 ), nextFrameTime( 0 )
+	{
+	}
+
+	/**
+	 * Reads next frame from the trace to the frame buffer.
+	 */
+	bool readFrame()
+	{
+		if( !reader.readFrame( frame.data(), nextFrameTime ) )
+		{
+			if( !reader.errorString().isEmpty() )
+			{
+				Log::error() << "Failed to replay positional data trace, reason: " << reader.errorString();
+			}
+			return false;
+		}
+		return true;
+	}
+
+	void shiftTimestamps( char *data )
+	{
+		using namespace WotSharedMemory;
+		const quint32 recordTime = reader.getStartTime() + nextFrameTime / 1000;
+		const quint32 now = QDateTime::currentDateTime().toTime_t();
+		const int size = frame.size();
+		PositionalDataHeader *header = (PositionalDataHeader*)data;
+		if( size < (int)sizeof( *header ) || qFromLittleEndian<quint32>( header->magic ) != POSITIONAL_DATA_MAGIC )
+		{
+			if( size >= (int)sizeof( PositionalData::timestamp ) )
+			{
+				shiftTimestamp( ((PositionalData*)data)->timestamp, recordTime, now );
+			}
+		}
+		else if( header->version == POSITIONAL_DATA_V3 && size >= (int)( sizeof( *header ) + sizeof( CameraRecord ) ) )
+		{
+			CameraRecord *camera = (CameraRecord*)( header + 1 );
+			shiftTimestamp( camera->timestamp, recordTime, now );
+			// the frame is written now, latency from the game is not replayed
+			if( camera->writeTime != 0 )
+			{
+				camera->writeTime = qToLittleEndian<quint64>( Latency::now() );
+			}
+		}
+	}
+
+	QTimer *writeTimer;
+	QSharedMemory *memory;
+	NamedEvent notifyEvent;
+	WotTraceReader reader;
+	QString filePath;
+	bool fast;
+	// next frame as recorded, copied to the memory when its time comes
+	QByteArray frame;
+	int frameCount;
+	quint32 nextFrameTime;
+	QElapsedTimer clock;
+};
+
+WotReplay::WotReplay( const QString &filePath, bool fast, QObject *parent )
+	: QObject( parent ), d_ptr( new WotReplayPrivate( this ) )
+{
+	Q_D( WotReplay );
+	d->filePath = filePath;
+	d->fast = fast;
+	d->memory->setNativeKey( WotSharedMemory::POSITIONAL_DATA_KEY );
+	d->writeTimer->setSingleShot( true );
+	d->writeTimer->setTimerType( Qt::PreciseTimer );
+	connect( d->writeTimer, SIGNAL(timeout()), this, SLOT(writeFrame()) );
+}
+
+WotReplay::~WotReplay()
+{
+	Q_D( WotReplay );
+	d->writeTimer->stop();
+	delete d;
+}
+
+void WotReplay::start()
+{
+	Q_D( WotReplay );
+	if( !d->reader.open( d->filePath ) )
+	{
+		Log::error() << "Failed to open positional data trace " << d->filePath << ", reason: " << d->reader.errorString();
+		return;
+	}
+	if( !d->memory->create( d->reader.getMemorySize() ) )
+	{
+		Log::error() << "Failed to create replayed positional data memory, reason: " << d->memory->errorString();
+		return;
+	}
+	if( !d->notifyEvent.create() )
+	{
+		Log::error() << "Failed to create replayed positional data notify event, reason: " << d->notifyEvent.errorString();
+	}
+	d->frame.fill( 0, d->reader.getMemorySize() );
+	if( !d->readFrame() )
+	{
+		return;
+	}
+	Log::info() << "Replaying positional data trace " << d->filePath << ( d->fast? " in fast mode": "" );
+	d->clock.start();
+	d->writeTimer->start( d->fast? 0: d->nextFrameTime );
+}
+
+void WotReplay::writeFrame()
+{
+	Q_D( WotReplay );
+	char *data = (char*)d->memory->data();
+	memcpy( data, d->frame.constData(), d->frame.size() );
+	d->shiftTimestamps( data );
+	// in fast mode frameWritten() triggers the read, the event would read
+	// each frame a second time
+	if( !d->fast )
+	{
+		d->notifyEvent.signal();
+	}
+	d->frameCount++;
+	emit frameWritten();
+
+	if( !d->readFrame() )
+	{
+		Log::info() << "Replayed " << QString::number( d->frameCount ) << " frames in " << QString::number( d->clock.elapsed() ) << " ms";
+		return;
+	}
+	d->writeTimer->start( d->fast? 0: qMax<qint64>( 0, d->nextFrameTime - d->clock.elapsed() ) );
+}
+
+}
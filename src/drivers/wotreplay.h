@@ -0,0 +1,59 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#pragma once
+
+#include <QObject>
+
+namespace Driver
+{
+class WotReplayPrivate;
+
+/**
+ * The WotReplay class stands in for the game by playing back a trace
+ * recorded by WotConnector to positional data shared memory.
+ *
+ * Frames are written at the pace they were recorded, or in fast mode as fast
+ * as they are read, in which case frameWritten() must be connected to
+ * reading of the memory as the positional data event is not signalled. Timestamps in the memory are shifted so that data
+ * keeps the age it had when recorded.
+ */
+class WotReplay : public QObject
+{
+	Q_OBJECT
+
+public:
+	WotReplay( const QString &filePath, bool fast, QObject *parent );
+	~WotReplay();
+
+	void start();
+
+signals:
+	void frameWritten();
+
+private slots:
+	void writeFrame();
+
+private:
+	WotReplayPrivate *const d_ptr;
+	Q_DECLARE_PRIVATE( WotReplay )
+};
+
+}
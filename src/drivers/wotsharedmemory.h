@@ -0,0 +1,172 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#pragma once
+
+#include <QtGlobal>
+
+/**
+ * @file
+ *
+ * Names and layout of the shared memory areas used to communicate with
+ * TessuMod in the game.
+ *
+ * Plugin info area holds a single quint8, PLUGIN_VERSION, which tells the
+ * game the newest positional data version the plugin can read. The game
+ * writes the newest version both sides support. Game modifications which
+ * predate version 3 ignore it and write version 1. Version 2 is not used.
+ *
+ * Positional data layout, version 3 (all values little-endian, floats are
+ * single precision):
+ *
+ *   offset  type       field
+ *   0       quint32    magic, POSITIONAL_DATA_MAGIC
+ *   4       quint8     version, POSITIONAL_DATA_V3
+ *   5       quint8[3]  reserved
+ *   8       quint32    sequence, incremented by the game on each write
+ *
+ * The header is followed by a camera record and by per client slots which
+ * are written only when they change:
+ *
+ *   12      quint32    generation, odd while the camera record is written
+ *   16      quint32    timestamp, unix time of the write
+ *   20      quint64    write time in nanoseconds of the monotonic clock
+ *                      described in latency.h, zero if unknown
+ *   28      float[3]   camera position
+ *   40      float[3]   camera direction
+ *   52      quint16    slot count, slots from this onwards are unused
+ *   54      quint8[2]  reserved
+ *   56      MAX_CLIENT_SLOTS slots of:
+ *           quint32    generation, odd while written, advanced on each change
+ *           quint16    client id
+ *           quint8     1 if the slot is used, otherwise 0
+ *           quint8     reserved
+ *           float[3]   position
+ *
+ * The camera record is written on each write, a slot only when its client
+ * joins, leaves or moves. A record's generation is incremented to odd before
+ * it is written and back to even after, then the sequence is incremented.
+ * The plugin retries a record if its generation was odd or changed during
+ * the copy, and reads only the slots whose generation differs from its
+ * previous read. A client may move to another slot.
+ *
+ * Version 1 layout has no header:
+ *
+ *   0       quint32    timestamp, unix time of the write
+ *   4       float[3]   camera position
+ *   16      float[3]   camera direction
+ *   28      quint8     client count
+ *   29      MAX_CLIENTS entries of: quint16 client id, float[3] position
+ *
+ * It has no protection against reading it while the game writes to it.
+ *
+ * After each write the game signals POSITIONAL_DATA_EVENT_NAME event (see
+ * NamedEvent) which both sides create if it doesn't exist yet.
+ */
+
+namespace WotSharedMemory
+{
+
+const char *const PLUGIN_INFO_KEY = "TessuModTSPluginInfo";
+const char *const POSITIONAL_DATA_KEY = "TessuModTSPlugin3dAudio";
+const char *const POSITIONAL_DATA_EVENT_NAME = "TessuModTSPlugin3dAudioEvent";
+
+// "TMP2", as a version 1 timestamp this would be in year 1996
+const quint32 POSITIONAL_DATA_MAGIC = 0x32504D54;
+// single block, polled
+const quint8 POSITIONAL_DATA_V1 = 1;
+// camera record and per client slots, notified
+const quint8 POSITIONAL_DATA_V3 = 3;
+const quint8 PLUGIN_VERSION = POSITIONAL_DATA_V3;
+const int MAX_CLIENTS = 255;
+const int MAX_CLIENT_SLOTS = 512;
+
+// views to the memory, values must be converted from little-endian when read
+#pragma pack(push, 1)
+
+struct Vector
+{
+	float x;
+	float y;
+	float z;
+};
+
+struct PositionalDataHeader
+{
+	quint32 magic;
+	quint8 version;
+	quint8 reserved[3];
+	quint32 sequence;
+};
+
+struct ClientEntry
+{
+	quint16 id;
+	Vector position;
+};
+
+struct PositionalData
+{
+	quint32 timestamp;
+	Vector cameraPosition;
+	Vector cameraDirection;
+	quint8 clientCount;
+	ClientEntry clients[MAX_CLIENTS];
+};
+
+struct CameraRecord
+{
+	quint32 generation;
+	quint32 timestamp;
+	quint64 writeTime;
+	Vector position;
+	Vector direction;
+	quint16 slotCount;
+	quint8 reserved[2];
+};
+
+struct ClientSlot
+{
+	quint32 generation;
+	quint16 id;
+	quint8 used;
+	quint8 reserved;
+	Vector position;
+};
+
+struct SlottedPositionalData
+{
+	CameraRecord camera;
+	ClientSlot clientSlots[MAX_CLIENT_SLOTS];
+};
+
+#pragma pack(pop)
+
+static_assert( sizeof( PositionalDataHeader ) == 12, "PositionalDataHeader must match the protocol" );
+static_assert( sizeof( ClientEntry ) == 14, "ClientEntry must match the protocol" );
+static_assert( sizeof( PositionalData ) == 29 + MAX_CLIENTS * 14, "PositionalData must match the protocol" );
+static_assert( sizeof( CameraRecord ) == 44, "CameraRecord must match the protocol" );
+static_assert( sizeof( ClientSlot ) == 20, "ClientSlot must match the protocol" );
+
+// memory reserved by the game, enough for any version
+const int POSITIONAL_DATA_SIZE = sizeof( PositionalData ) > sizeof( PositionalDataHeader ) + sizeof( SlottedPositionalData )
+	? sizeof( PositionalData ): sizeof( PositionalDataHeader ) + sizeof( SlottedPositionalData );
+
+}
@@ -0,0 +1,169 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include "wotsimulator.h"
+#include "wotsharedmemory.h"
+#include "../utils/logging.h"
+#include "../utils/namedevent.h"
+#include "../utils/latency.h"
+
+#include <QTimer>
+#include <QSharedMemory>
+#include <QtEndian>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <cmath>
+#include <cstring>
+#include <atomic>
+
+namespace {
+
+// the game writes positions on each frame, at roughly this rate
+const int WRITE_INTERVAL = 33;
+const float PI = 3.14159265358979323846f;
+const float CLIENT_DISTANCE = 20.0f;
+const float CAMERA_TURN_SPEED = 0.2f;
+const float CLIENT_TURN_SPEED = 0.5f;
+
+float toLittleEndian( float value )
+{
+	quint32 bits;
+	memcpy( &bits, &value, sizeof( bits ) );
+	bits = qToLittleEndian<quint32>( bits );
+	memcpy( &value, &bits, sizeof( value ) );
+	return value;
+}
+
+WotSharedMemory::Vector toVector( float x, float y, float z )
+{
+	WotSharedMemory::Vector vector;
+	vector.x = toLittleEndian( x );
+	vector.y = toLittleEndian( y );
+	vector.z = toLittleEndian( z );
+	return vector;
+}
+
+void storeGeneration( quint32 &target, quint32 value )
+{
+	std::atomic_thread_fence( std::memory_order_release );
+	*(volatile quint32*)&target = qToLittleEndian<quint32>( value );
+	std::atomic_thread_fence( std::memory_order_release );
+}
+
+}
+
+namespace Driver
+{
+
+class WotSimulatorPrivate
+{
+public:
+	WotSimulatorPrivate( WotSimulator *q )
+		: writeTimer( new QTimer( q ) ), memory( new QSharedMemory( q ) ),
+		  notifyEvent( WotSharedMemory::POSITIONAL_DATA_EVENT_NAME ), sequence( 0 ), cameraGeneration( 0 )
+	{
+		for( int i = 0; i < WotSharedMemory::MAX_CLIENT_SLOTS; i++ )
+		{
+			slotGenerations[i] = 0;
+		}
+	}
+
+	QTimer *writeTimer;
+	QSharedMemory *memory;
+	NamedEvent notifyEvent;
+	QList<quint16> clientIds;
+	QElapsedTimer clock;
+	quint32 sequence;
+	quint32 cameraGeneration;
+	quint32 slotGenerations[WotSharedMemory::MAX_CLIENT_SLOTS];
+};
+
+WotSimulator::WotSimulator( const QList<quint16> &clientIds, QObject *parent )
+	: QObject( parent ), d_ptr( new WotSimulatorPrivate( this ) )
+{
+	Q_D( WotSimulator );
+	d->clientIds = clientIds.mid( 0, WotSharedMemory::MAX_CLIENT_SLOTS );
+	d->memory->setNativeKey( WotSharedMemory::POSITIONAL_DATA_KEY );
+	d->writeTimer->setInterval( WRITE_INTERVAL );
+	connect( d->writeTimer, SIGNAL(timeout()), this, SLOT(writeMemory()) );
+}
+
+WotSimulator::~WotSimulator()
+{
+	Q_D( WotSimulator );
+	d->writeTimer->stop();
+	delete d;
+}
+
+void WotSimulator::start()
+{
+	Q_D( WotSimulator );
+	if( !d->memory->create( WotSharedMemory::POSITIONAL_DATA_SIZE ) )
+	{
+		Log::error() << "Failed to create simulated positional data memory, reason: " << d->memory->errorString();
+		return;
+	}
+	if( !d->notifyEvent.create() )
+	{
+		Log::error() << "Failed to create simulated positional data notify event, reason: " << d->notifyEvent.errorString();
+	}
+	Log::info() << "Simulating game with " << QString::number( d->clientIds.size() ) << " clients";
+	d->clock.start();
+	d->writeTimer->start();
+}
+
+void WotSimulator::writeMemory()
+{
+	Q_D( WotSimulator );
+	const float time = d->clock.elapsed() / 1000.0f;
+	const float cameraAngle = time * CAMERA_TURN_SPEED;
+
+	// write in version 3 layout, see wotsharedmemory.h
+	WotSharedMemory::PositionalDataHeader *header = (WotSharedMemory::PositionalDataHeader*)d->memory->data();
+	WotSharedMemory::SlottedPositionalData *data = (WotSharedMemory::SlottedPositionalData*)( header + 1 );
+
+	WotSharedMemory::CameraRecord &camera = data->camera;
+	storeGeneration( camera.generation, ++d->cameraGeneration );
+	camera.timestamp = qToLittleEndian<quint32>( QDateTime::currentDateTime().toTime_t() );
+	camera.position = toVector( 0, 0, 0 );
+	camera.direction = toVector( std::sin( cameraAngle ), 0, std::cos( cameraAngle ) );
+	camera.slotCount = qToLittleEndian<quint16>( d->clientIds.size() );
+	camera.writeTime = qToLittleEndian<quint64>( Latency::now() );
+	storeGeneration( camera.generation, ++d->cameraGeneration );
+
+	// every simulated client moves on each frame, so every slot is written
+	for( int i = 0; i < d->clientIds.size(); i++ )
+	{
+		const float clientAngle = time * CLIENT_TURN_SPEED + i * 2 * PI / d->clientIds.size();
+		WotSharedMemory::ClientSlot &slot = data->clientSlots[i];
+		storeGeneration( slot.generation, ++d->slotGenerations[i] );
+		slot.id = qToLittleEndian<quint16>( d->clientIds[i] );
+		slot.used = 1;
+		slot.position = toVector( CLIENT_DISTANCE * std::sin( clientAngle ), 0, CLIENT_DISTANCE * std::cos( clientAngle ) );
+		storeGeneration( slot.generation, ++d->slotGenerations[i] );
+	}
+
+	header->magic = qToLittleEndian<quint32>( WotSharedMemory::POSITIONAL_DATA_MAGIC );
+	header->version = WotSharedMemory::POSITIONAL_DATA_V3;
+	storeGeneration( header->sequence, ++d->sequence );
+	d->notifyEvent.signal();
+}
+
+}
@@ -0,0 +1,55 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QList>
+
+namespace Driver
+{
+class WotSimulatorPrivate;
+
+/**
+ * The WotSimulator class stands in for TessuMod in the game by writing
+ * positional data to shared memory like the game does.
+ *
+ * Camera stays in origin, turning around slowly, and given TeamSpeak clients
+ * circle around it. Used for testing the plugin without the game.
+ */
+class WotSimulator : public QObject
+{
+	Q_OBJECT
+
+public:
+	WotSimulator( const QList<quint16> &clientIds, QObject *parent );
+	~WotSimulator();
+
+	void start();
+
+private slots:
+	void writeMemory();
+
+private:
+	WotSimulatorPrivate *const d_ptr;
+	Q_DECLARE_PRIVATE( WotSimulator )
+};
+
+}
@@ -0,0 +1,190 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include "wottrace.h"
+
+#include <QDateTime>
+#include <QVector>
+#include <QPair>
+#include <cstring>
+
+namespace
+{
+
+const quint32 TRACE_MAGIC = 0x52544D54; // "TMTR"
+const quint8 TRACE_VERSION = 1;
+// unchanged bytes shorter than this between two changes are stored as part
+// of one run, as a run header would take more space
+const int MIN_RUN_GAP = 8;
+
+}
+
+namespace Driver
+{
+
+WotTraceWriter::WotTraceWriter()
+{
+	stream.setByteOrder( QDataStream::LittleEndian );
+}
+
+bool WotTraceWriter::open( const QString &filePath, int memorySize )
+{
+	file.setFileName( filePath );
+	if( !file.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
+	{
+		return false;
+	}
+	stream.setDevice( &file );
+	stream << TRACE_MAGIC << TRACE_VERSION << (quint32)memorySize << (quint32)QDateTime::currentDateTime().toTime_t();
+	previous.fill( 0, memorySize );
+	clock.start();
+	return true;
+}
+
+void WotTraceWriter::close()
+{
+	stream.setDevice( NULL );
+	file.close();
+}
+
+bool WotTraceWriter::isOpen() const
+{
+	return file.isOpen();
+}
+
+QString WotTraceWriter::errorString() const
+{
+	return file.errorString();
+}
+
+void WotTraceWriter::write( const char *memory )
+{
+	const int size = previous.size();
+	char *previousData = previous.data();
+	if( memcmp( memory, previousData, size ) == 0 )
+	{
+		return;
+	}
+
+	// find runs of changed bytes, gaps shorter than MIN_RUN_GAP included
+	QVector<QPair<int, int> > runs;
+	int offset = 0;
+	while( offset < size )
+	{
+		if( memory[offset] == previousData[offset] )
+		{
+			offset++;
+			continue;
+		}
+		int end = offset + 1;
+		for( int gap = 0; end < size && gap < MIN_RUN_GAP; end++ )
+		{
+			gap = memory[end] == previousData[end]? gap + 1: 0;
+		}
+		while( memory[end - 1] == previousData[end - 1] )
+		{
+			end--;
+		}
+		runs.append( qMakePair( offset, end - offset ) );
+		offset = end;
+	}
+
+	stream << (quint32)clock.elapsed() << (quint16)runs.size();
+	for( int i = 0; i < runs.size(); i++ )
+	{
+		stream << (quint32)runs[i].first << (quint32)runs[i].second;
+		stream.writeRawData( memory + runs[i].first, runs[i].second );
+	}
+	memcpy( previousData, memory, size );
+	file.flush();
+}
+
+WotTraceReader::WotTraceReader()
+	: memorySize( 0 ), startTime( 0 )
+{
+	stream.setByteOrder( QDataStream::LittleEndian );
+}
+
+bool WotTraceReader::open( const QString &filePath )
+{
+	file.setFileName( filePath );
+	if( !file.open( QIODevice::ReadOnly ) )
+	{
+		error = file.errorString();
+		return false;
+	}
+	stream.setDevice( &file );
+	quint32 magic;
+	quint8 version;
+	stream >> magic >> version >> memorySize >> startTime;
+	if( stream.status() != QDataStream::Ok || magic != TRACE_MAGIC || version != TRACE_VERSION )
+	{
+		error = "Not a positional data trace file";
+		close();
+		return false;
+	}
+	return true;
+}
+
+void WotTraceReader::close()
+{
+	stream.setDevice( NULL );
+	file.close();
+}
+
+QString WotTraceReader::errorString() const
+{
+	return error;
+}
+
+int WotTraceReader::getMemorySize() const
+{
+	return memorySize;
+}
+
+quint32 WotTraceReader::getStartTime() const
+{
+	return startTime;
+}
+
+bool WotTraceReader::readFrame( char *memory, quint32 &time )
+{
+	if( stream.atEnd() )
+	{
+		return false;
+	}
+	quint16 runCount;
+	stream >> time >> runCount;
+	for( int i = 0; i < runCount; i++ )
+	{
+		quint32 offset;
+		quint32 length;
+		stream >> offset >> length;
+		if( stream.status() != QDataStream::Ok || offset > memorySize || length > memorySize - offset )
+		{
+			error = "Broken frame in trace file";
+			return false;
+		}
+		stream.readRawData( memory + offset, length );
+	}
+	return stream.status() == QDataStream::Ok;
+}
+
+}
@@ -0,0 +1,103 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#pragma once
+
+#include <QFile>
+#include <QDataStream>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+namespace Driver
+{
+
+/**
+ * Trace of positional data memory, written by WotConnector when recording
+ * and played back by WotReplay.
+ *
+ * File format, in little endian:
+ *   quint32    magic, TRACE_MAGIC
+ *   quint8     format version, TRACE_VERSION
+ *   quint32    size of the memory
+ *   quint32    time when recording started, seconds since epoch
+ *   frames of:
+ *     quint32  time since recording started in milliseconds
+ *     quint16  count of changed runs
+ *     runs of:
+ *       quint32  offset in the memory
+ *       quint32  length of the run
+ *       bytes    new content of the run
+ *
+ * Each frame holds only bytes which differ from previous frame. The first
+ * frame is compared against zeroed memory.
+ */
+class WotTraceWriter
+{
+public:
+	WotTraceWriter();
+
+	bool open( const QString &filePath, int memorySize );
+	void close();
+	bool isOpen() const;
+	QString errorString() const;
+
+	/**
+	 * Appends memory as a new frame if it differs from previous frame.
+	 */
+	void write( const char *memory );
+
+private:
+	Q_DISABLE_COPY( WotTraceWriter )
+
+	QFile file;
+	QDataStream stream;
+	QByteArray previous;
+	QElapsedTimer clock;
+};
+
+class WotTraceReader
+{
+public:
+	WotTraceReader();
+
+	bool open( const QString &filePath );
+	void close();
+	QString errorString() const;
+	int getMemorySize() const;
+	quint32 getStartTime() const;
+
+	/**
+	 * Applies next frame to memory of getMemorySize() bytes.
+	 *
+	 * @returns false at end of trace or on a broken frame
+	 */
+	bool readFrame( char *memory, quint32 &time );
+
+private:
+	Q_DISABLE_COPY( WotTraceReader )
+
+	QFile file;
+	QDataStream stream;
+	QString error;
+	quint32 memorySize;
+	quint32 startTime;
+};
+
+}
@@ -37,7 +37,8 @@ enum AudioBackend
  */
 enum {
 	MENU_ID_GLOBAL_SETTINGS,
-	MENU_ID_GLOBAL_HELP
+	MENU_ID_GLOBAL_HELP,
+	MENU_ID_GLOBAL_STATISTICS
 };
 
 enum RotateMode : short
@@ -0,0 +1,47 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include "gamestate.h"
+
+namespace Entity
+{
+
+GameState::GameState()
+	: cameraChanged( false ), writeTime( 0 ), readTime( 0 )
+{
+}
+
+bool GameState::isEmpty() const
+{
+	return addedUsers.isEmpty() && removedUsers.isEmpty() && movedUsers.isEmpty() && !cameraChanged;
+}
+
+void GameState::clear()
+{
+	// resize keeps capacity so that reused states do not allocate
+	addedUsers.resize( 0 );
+	removedUsers.resize( 0 );
+	movedUsers.resize( 0 );
+	cameraChanged = false;
+	writeTime = 0;
+	readTime = 0;
+}
+
+}
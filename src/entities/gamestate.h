@@ -0,0 +1,62 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#pragma once
+
+#include <QtGlobal>
+#include <QVector>
+#include <QMetaType>
+#include "vector.h"
+
+namespace Entity
+{
+
+struct UserPosition
+{
+	quint16 id;
+	Vector position;
+};
+
+/**
+ * The GameState class holds changes in game's positional data since previous
+ * state, so that all changes of one game frame are handled at once.
+ */
+class GameState
+{
+public:
+	GameState();
+
+	bool isEmpty() const;
+	void clear();
+
+	QVector<quint16> addedUsers;
+	QVector<quint16> removedUsers;
+	QVector<UserPosition> movedUsers;
+	bool cameraChanged;
+	Vector cameraPosition;
+	Vector cameraDirection;
+	// times of newest data behind the state, see latency.h, zero if unknown
+	qint64 writeTime;
+	qint64 readTime;
+};
+
+}
+
+Q_DECLARE_METATYPE( Entity::GameState )
@@ -25,8 +25,9 @@ namespace Entity
 
 Settings::Settings()
 	: audioBackend( OpenALBackend ), positioningEnabled( true ),
-	  testRotateMode( RotateYAxis ), hrtfEnabled( false ),
-	  audioLoggingLevel( 0 )
+	  testRotateMode( RotateYAxis ), hrtfEnabled( false ), hrtfVoiceLimit( 8 ),
+	  audioLoggingLevel( 0 ), poseUpdateRate( 60 ),
+	  positionAngleThreshold( 1.0 ), positionDistanceThreshold( 2.0 )
 {
 }
 
@@ -36,7 +36,15 @@ public:
 	RotateMode testRotateMode;
 	bool hrtfEnabled;
 	QString hrtfDataSet;
+	// amount of speakers positioned with HRTF at once, 0 for no limit
+	int hrtfVoiceLimit;
 	int audioLoggingLevel;
+	// rate of extrapolated position updates per second, 0 to disable
+	int poseUpdateRate;
+	// pose changes relative to the listener smaller than these are not
+	// given to audio backends, angle in degrees and distance in percents
+	qreal positionAngleThreshold;
+	qreal positionDistanceThreshold;
 };
 
 }
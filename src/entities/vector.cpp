@@ -49,11 +49,26 @@ Vector Vector::crossProduct( const Vector &other ) const
 	);
 }
 
+qreal Vector::dotProduct( const Vector &other ) const
+{
+	return x * other.x + y * other.y + z * other.z;
+}
+
+Vector Vector::operator*( qreal multiplier ) const
+{
+	return Vector( x * multiplier, y * multiplier, z * multiplier );
+}
+
 Vector Vector::operator/( qreal divider ) const
 {
 	return Vector( x / divider, y / divider, z / divider );
 }
 
+Vector Vector::operator+( const Vector &other ) const
+{
+	return Vector( x + other.x, y + other.y, z + other.z );
+}
+
 Vector Vector::operator-( const Vector &other ) const
 {
 	return Vector( x - other.x, y - other.y, z - other.z );
@@ -34,7 +34,10 @@ public:
 	Vector getUnit() const;
 	qreal getLength() const;
 	Vector crossProduct( const Vector &other ) const;
+	qreal dotProduct( const Vector &other ) const;
+	Vector operator*( qreal multiplier ) const;
 	Vector operator/( qreal divider ) const;
+	Vector operator+( const Vector &other ) const;
 	Vector operator-( const Vector &other ) const;
 	bool operator==( const Vector &other ) const;
 	bool operator!=( const Vector &other ) const;
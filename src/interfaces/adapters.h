@@ -48,6 +48,7 @@ public:
 	virtual void positionUser( const Entity::User &user ) = 0;
 	virtual void removeUser( const Entity::User &user ) = 0;
 	virtual void positionCamera( const Entity::Camera &camera ) = 0;
+	virtual void flush() = 0;
 
 	virtual void setPlaybackDeviceName( const QString &name ) = 0;
 	virtual void setPlaybackVolume( float volume ) = 0;
@@ -56,6 +57,7 @@ public:
 
 	virtual void setHrtfEnabled( bool enabled ) = 0;
 	virtual void setHrtfDataSet( const QString &name ) = 0;
+	virtual void setHrtfVoiceLimit( int limit ) = 0;
 	virtual QStringList getHrtfDataFileNames() const = 0;
 	virtual void playTestSound( Entity::RotateMode mode, Callback result ) = 0;
 	virtual void setLoggingLevel( int level ) = 0;
@@ -74,6 +76,8 @@ class GameDataAdapter
 {
 public:
 	virtual ~GameDataAdapter() {}
+	virtual void setPoseUpdateRate( int rate ) = 0;
+	virtual QStringList getStatistics() const = 0;
 };
 
 class UiAdapter
@@ -81,6 +85,7 @@ class UiAdapter
 public:
 	virtual ~UiAdapter() {}
 	virtual void showSettingsUi( const Entity::Settings &settings, const QStringList &hrtfDataNames, QWidget *parent ) = 0;
+	virtual void showStatistics( const QStringList &lines, QWidget *parent ) = 0;
 };
 
 }
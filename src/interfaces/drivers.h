@@ -41,12 +41,15 @@ public:
 	virtual void removeUser( quint16 id ) = 0;
 	virtual void positionUser( quint16 id, const Entity::Vector &position ) = 0;
 	virtual void positionCamera( const Entity::Vector &position, const Entity::Vector &forward, const Entity::Vector &up ) = 0;
+	// applies user and camera changes given since previous flush at once
+	virtual void flush() = 0;
 
 	virtual void setPlaybackDeviceName( const QString &name ) = 0;
 	virtual void setPlaybackVolume( float volume ) = 0;
 
 	virtual void setHrtfEnabled( bool enabled ) = 0;
 	virtual void setHrtfDataSet( const QString &name ) = 0;
+	virtual void setHrtfVoiceLimit( int limit ) = 0;
 	virtual void setLoggingLevel( int level ) = 0;
 	virtual QStringList getHrtfDataFileNames() const = 0;
 
@@ -78,6 +81,7 @@ class GameDataDriver
 public:
 	virtual ~GameDataDriver() {}
 	virtual QObject* qtObj() = 0;
+	virtual QStringList getStatistics() const = 0;
 };
 
 class AudioSink
@@ -21,10 +21,12 @@
 #pragma once
 
 #include <QtGlobal>
+#include <functional>
 
 namespace Entity
 {
 class User;
+struct UserPosition;
 class Camera;
 class Settings;
 }
@@ -53,12 +55,17 @@ public:
 class UserStorage
 {
 public:
+	typedef std::function<void(const Entity::User&)> Visitor;
+
 	virtual ~UserStorage() {}
 	virtual bool has( quint16 id ) const = 0;
 	virtual Entity::User get( quint16 id ) const = 0;
 	virtual QList<Entity::User> getAll() const = 0;
 	virtual void set( const Entity::User &user ) = 0;
 	virtual void remove( quint16 id ) = 0;
+	virtual void updatePositions( const Entity::UserPosition *positions, int count ) = 0;
+	virtual void visitPaired( const Visitor &visitor ) const = 0;
+	virtual void visitDirty( const Visitor &visitor ) = 0;
 };
 
 class CameraStorage
@@ -30,6 +30,7 @@ namespace Entity
 {
 class Vector;
 class Settings;
+class GameState;
 }
 
 namespace Interfaces
@@ -42,10 +43,7 @@ public:
 
 	virtual ~UseCaseFactory() {}
 	virtual void applicationInitialize() = 0;
-	virtual void positionUser( quint16 id, const Entity::Vector& position ) = 0;
-	virtual void positionCamera( const Entity::Vector& position, const Entity::Vector& direction ) = 0;
-	virtual void addGameUser( quint16 id ) = 0;
-	virtual void removeGameUser( quint16 id ) = 0;
+	virtual void updateGameState( const Entity::GameState &state ) = 0;
 	virtual void addChatUser( quint16 id ) = 0;
 	virtual void removeChatUser( quint16 id ) = 0;
 	virtual void changePlaybackDevice() = 0;
@@ -54,6 +52,7 @@ public:
 	virtual void saveSettings( const Entity::Settings &settings ) = 0;
 	virtual void playTestAudioWithSettings( const Entity::Settings &settings, Callback result ) = 0;
 	virtual void showPluginHelp() = 0;
+	virtual void showStatistics( QWidget *parent ) = 0;
 };
 
 }
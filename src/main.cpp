@@ -31,6 +31,8 @@
 #include "drivers/inisettingsfile.h"
 #include "drivers/openalbackend.h"
 #include "drivers/wotconnector.h"
+#include "drivers/wotsimulator.h"
+#include "drivers/wotreplay.h"
 #include "openal/openal.h"
 #include "openal/structures.h"
 
@@ -84,6 +86,37 @@ void pluginInit( QObject *parent )
 
 	teamSpeakPlugin->setAudioSink( openALBackend );
 
+	// for testing without the game, e.g. TESSUMOD_SIMULATE_GAME=2,3 positions
+	// TeamSpeak clients with ids 2 and 3
+	Driver::WotSimulator *wotSimulator = NULL;
+	if( qEnvironmentVariableIsSet( "TESSUMOD_SIMULATE_GAME" ) )
+	{
+		QList<quint16> clientIds;
+		foreach( const QString &id, QString( qgetenv( "TESSUMOD_SIMULATE_GAME" ) ).split( ",", QString::SkipEmptyParts ) )
+		{
+			clientIds.append( id.trimmed().toUShort() );
+		}
+		wotSimulator = new Driver::WotSimulator( clientIds, parent );
+	}
+
+	// TESSUMOD_RECORD_GAME=<file> records positional data from the game and
+	// TESSUMOD_REPLAY_GAME=<file> plays it back in place of the game, as fast
+	// as possible if TESSUMOD_REPLAY_FAST is set
+	if( qEnvironmentVariableIsSet( "TESSUMOD_RECORD_GAME" ) )
+	{
+		wotConnector->setRecordFilePath( QString( qgetenv( "TESSUMOD_RECORD_GAME" ) ) );
+	}
+	Driver::WotReplay *wotReplay = NULL;
+	if( qEnvironmentVariableIsSet( "TESSUMOD_REPLAY_GAME" ) )
+	{
+		const bool fast = qEnvironmentVariableIsSet( "TESSUMOD_REPLAY_FAST" );
+		wotReplay = new Driver::WotReplay( QString( qgetenv( "TESSUMOD_REPLAY_GAME" ) ), fast, parent );
+		if( fast )
+		{
+			QObject::connect( wotReplay, SIGNAL(frameWritten()), wotConnector, SLOT(readMemory()) );
+		}
+	}
+
 	QTimer *setupTimer = new QTimer( parent );
 	setupTimer->setSingleShot( true );
 	setupTimer->setInterval( 0 );
@@ -91,6 +124,14 @@ void pluginInit( QObject *parent )
 
 	QObject::connect( setupTimer, &QTimer::timeout, [=] {
 		teamSpeakPlugin->initialize();
+		if( wotSimulator )
+		{
+			wotSimulator->start();
+		}
+		if( wotReplay )
+		{
+			wotReplay->start();
+		}
 		wotConnector->initialize();
 		useCaseFactory->applicationInitialize();
 		openALConfFile->start();
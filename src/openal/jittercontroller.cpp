@@ -0,0 +1,83 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include "jittercontroller.h"
+
+#include <cmath>
+
+namespace
+{
+const qint64 TALK_BURST_GAP  = 200; // ms
+const int MIN_PREBUFFER      = 10; // ms
+const int MAX_PREBUFFER      = 100; // ms
+// prebuffer is this many times the estimated jitter
+const qreal JITTER_MULTIPLIER = 3;
+// weight of a new jitter sample in the moving average
+const qreal JITTER_GAIN       = 1.0 / 16;
+}
+
+namespace OpenAL {
+
+JitterController::JitterController()
+	: lastArrivalTime( -1 ), lastDuration( 0 ), jitter( 0 )
+{
+}
+
+bool JitterController::packetReceived( qint64 arrivalTime, qreal duration )
+{
+	const bool burstStarted = lastArrivalTime < 0 || arrivalTime - lastArrivalTime > TALK_BURST_GAP;
+	if( !burstStarted )
+	{
+		// packets should arrive at the pace of their audio, any deviation
+		// must be covered by the buffered audio
+		const qreal deviation = std::fabs( ( arrivalTime - lastArrivalTime ) - lastDuration );
+		jitter += ( deviation - jitter ) * JITTER_GAIN;
+	}
+	lastArrivalTime = arrivalTime;
+	lastDuration = duration;
+	return burstStarted;
+}
+
+void JitterController::queueDepthMeasured( qreal depth )
+{
+	// source nearly drained, raise the estimate before it becomes an underrun
+	if( depth < MIN_PREBUFFER / 2.0 )
+	{
+		jitter = qMin( jitter + ( MIN_PREBUFFER / 2.0 - depth ) / JITTER_MULTIPLIER, MAX_PREBUFFER / JITTER_MULTIPLIER );
+	}
+}
+
+void JitterController::underrun()
+{
+	// the prebuffer was too short by at least one packet
+	jitter = qMin( jitter + lastDuration / JITTER_MULTIPLIER, MAX_PREBUFFER / JITTER_MULTIPLIER );
+}
+
+void JitterController::burstEnded()
+{
+	lastArrivalTime = -1;
+}
+
+int JitterController::getPrebufferDuration() const
+{
+	return qBound( MIN_PREBUFFER, qRound( jitter * JITTER_MULTIPLIER ), MAX_PREBUFFER );
+}
+
+}
@@ -0,0 +1,85 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#pragma once
+#include <QtGlobal>
+
+namespace OpenAL {
+
+/**
+ * The JitterController class decides how much silence is buffered ahead of
+ * a streaming source's audio when its playback starts.
+ *
+ * The controller tracks variation of audio packet inter-arrival times as an
+ * exponentially weighted moving average (as in RFC 3550) together with
+ * source's queue depth and underruns, and sizes the prebuffer so that it
+ * just covers the observed jitter.
+ */
+class JitterController
+{
+public:
+	/**
+	 * Default constructor.
+	 * Builds a controller which starts with the minimum prebuffer.
+	 */
+	JitterController();
+
+	/**
+	 * Registers arrival of an audio packet.
+	 *
+	 * @param arrivalTime monotonic arrival time in milliseconds
+	 * @param duration    duration of the packet's audio in milliseconds
+	 * @return true if the packet starts a new talk burst
+	 */
+	bool packetReceived( qint64 arrivalTime, qreal duration );
+
+	/**
+	 * Registers amount of audio queued to the source but not yet played,
+	 * measured when a packet arrives while the source is playing.
+	 *
+	 * @param depth queued audio in milliseconds
+	 */
+	void queueDepthMeasured( qreal depth );
+
+	/**
+	 * Registers that the source ran out of audio in middle of a talk burst.
+	 */
+	void underrun();
+
+	/**
+	 * Registers that the talk burst ended on purpose, e.g. its audio moved
+	 * to another source, so that the next packet starts a new burst.
+	 */
+	void burstEnded();
+
+	/**
+	 * Returns duration of silence to queue before audio of a talk burst.
+	 *
+	 * @return prebuffer duration in milliseconds
+	 */
+	int getPrebufferDuration() const;
+
+private:
+	qint64 lastArrivalTime;
+	qreal lastDuration;
+	qreal jitter;
+};
+
+}
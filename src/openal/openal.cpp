@@ -34,13 +34,37 @@
 #include <QSettings>
 
 const char *OPENAL_LOG_CHANNEL = "OpenAL";
-static QMutex gMutex;
+// recursive so that a batch started with beginUpdate() can call the other
+// functions
+static QMutex gMutex( QMutex::Recursive );
+static int gBatchDepth = 0;
+static OpenAL::OutputInfo gBatchOutputInfo;
+static ALCcontext *gBatchContext = NULL;
 static int gLogLevel = 0;
 static QSharedPointer<QFileSystemWatcher> gLogFileWatcher;
 static int gLastLogFilePos;
 
 namespace OpenAL {
 
+static void applyContext( const OutputInfo &outputInfo )
+{
+	// context is already current for the duration of a batch, unless a
+	// call within the batch has selected another output's context
+	if( gBatchDepth == 0 || outputInfo != gBatchOutputInfo || Proxies::getContext() != gBatchContext )
+	{
+		PrivateImpl::selectContext( outputInfo );
+	}
+}
+
+static void checkErrors( const char *batchName )
+{
+	// errors within a batch are checked when the batch is committed
+	if( gBatchDepth == 0 )
+	{
+		Proxies::checkErrors( batchName );
+	}
+}
+
 void free()
 {
 	reset();
@@ -62,6 +86,11 @@ bool setupLogging( int logLevel )
 		QString logPath =  QDir::toNativeSeparators( QDir::tempPath() + "/tessumod_openal.log" );
 		qputenv( "ALSOFT_LOGFILE", logPath.toLocal8Bit() );
 		qputenv( "ALSOFT_LOGLEVEL", QString::number( gLogLevel ).toLocal8Bit() );
+		{
+			// check every call when debugging
+			QMutexLocker locker( &gMutex );
+			Proxies::setErrorCheckMode( gLogLevel >= 4? Proxies::CheckPerCall: Proxies::getDefaultErrorCheckMode() );
+		}
 		gLogFileWatcher.reset( new QFileSystemWatcher() );
 		gLogFileWatcher->addPath( logPath );
 		QObject::connect( gLogFileWatcher.data(), &QFileSystemWatcher::fileChanged, [=]( const QString &path ) {
@@ -123,6 +152,11 @@ bool setConfigValue( const QString &name, const QString &value )
 }
 
 void playAudio( const SourceInfo &sourceInfo, const AudioData &audioData )
+{
+	playAudio( sourceInfo, audioData, SourceInfo() );
+}
+
+void playAudio( const SourceInfo &sourceInfo, const AudioData &audioData, const SourceInfo &syncSourceInfo )
 {
 	if( !sourceInfo.isValid() )
 	{
@@ -130,33 +164,45 @@ void playAudio( const SourceInfo &sourceInfo, const AudioData &audioData )
 	}
 
 	QMutexLocker locker( &gMutex );
-	PrivateImpl::applyThreadContext( sourceInfo.getOutputInfo() );
+	applyContext( sourceInfo.getOutputInfo() );
 	PrivateImpl::updateSourceOptions( sourceInfo );
 	ALuint buffer = 0, silentBuffer = 0;
 
 	try
 	{
-		buffer = PrivateImpl::bufferAudioData( audioData );
 		ALuint source = PrivateImpl::querySource( sourceInfo );
 
 		bool isPlaying = PrivateImpl::isSourcePlaying( sourceInfo );
 
 		if( sourceInfo.isStreaming() )
 		{
-			PrivateImpl::cleanupProcessedBuffers( sourceInfo );
-			if( !isPlaying )
+			// return buffers which have been played back to source's buffer
+			// pool before taking new ones from there
+			PrivateImpl::recycleProcessedBuffers( sourceInfo );
+			const qreal prebuffer = PrivateImpl::queryPrebufferDuration( sourceInfo, audioData, isPlaying, syncSourceInfo );
+			buffer = PrivateImpl::bufferStreamAudioData( sourceInfo, audioData );
+			// delay start of playback by just enough to cover jitter in
+			// arrival of following audio data, or to line up with the sync
+			// source, in pieces of up to 100 ms of stereo float audio (zero
+			// bytes are silence in all sample formats)
+			static const char silence[2 * sizeof(float) * 48000 / 10] = {};
+			const quint32 frameSize = audioData.getChannelCount() * audioData.getSampleSize() / 8;
+			quint32 silenceSize = qRound( prebuffer * audioData.getSampleRate() / 1000 ) * frameSize;
+			while( silenceSize > 0 )
 			{
-				// delay start of playback a bit so that we don't starve the playback device
-				short silence[48000 / 10] = {};
-				silentBuffer = PrivateImpl::bufferAudioData( AudioData( 1, sizeof(short) * 8, sizeof(silence), 48000, silence ) );
-				Proxies::alSourceQueueBuffers( source, 1, &silentBuffer );
+				const quint32 size = qMin<quint32>( sizeof(silence) / frameSize * frameSize, silenceSize );
+				const AudioData silenceData( audioData.getChannelCount(), audioData.getSampleSize(), size, audioData.getSampleRate(), silence );
+				silentBuffer = PrivateImpl::bufferStreamAudioData( sourceInfo, silenceData );
+				PrivateImpl::queueStreamBuffer( sourceInfo, silentBuffer, silenceData );
 				silentBuffer = 0;
+				silenceSize -= size;
 			}
-			Proxies::alSourceQueueBuffers( source, 1, &buffer );
+			PrivateImpl::queueStreamBuffer( sourceInfo, buffer, audioData );
 			buffer = 0;
 		}
 		else
 		{
+			buffer = PrivateImpl::bufferAudioData( audioData );
 			Proxies::alSourcei( source, AL_BUFFER, buffer );
 			buffer = 0;
 		}
@@ -165,23 +211,27 @@ void playAudio( const SourceInfo &sourceInfo, const AudioData &audioData )
 		{
 			Proxies::alSourcePlay( source );
 		}
+		checkErrors( "playAudio" );
 	}
 	catch( ... )
 	{
 		// something went wrong, release buffers if possible
-		if( buffer )
+		if( sourceInfo.isStreaming() )
 		{
-			try
+			if( buffer )
 			{
-				Proxies::alDeleteBuffers( 1, &buffer );
+				PrivateImpl::recycleStreamBuffer( sourceInfo, buffer );
+			}
+			if( silentBuffer )
+			{
+				PrivateImpl::recycleStreamBuffer( sourceInfo, silentBuffer );
 			}
-			catch( ... ) {}
 		}
-		if( silentBuffer )
+		else if( buffer )
 		{
 			try
 			{
-				Proxies::alDeleteBuffers( 1, &silentBuffer );
+				Proxies::alDeleteBuffers( 1, &buffer );
 			}
 			catch( ... ) {}
 		}
@@ -189,14 +239,50 @@ void playAudio( const SourceInfo &sourceInfo, const AudioData &audioData )
 	}
 }
 
+bool isFloatFormatSupported( const OutputInfo &outputInfo )
+{
+	QMutexLocker locker( &gMutex );
+	applyContext( outputInfo );
+	return PrivateImpl::isFloatFormatSupported();
+}
+
+bool isDirectChannelsSupported( const OutputInfo &outputInfo )
+{
+	QMutexLocker locker( &gMutex );
+	applyContext( outputInfo );
+	return PrivateImpl::isDirectChannelsSupported();
+}
+
 void stopAudio( const SourceInfo &sourceInfo )
 {
 	if( sourceInfo.isValid() )
 	{
 		QMutexLocker locker( &gMutex );
-		PrivateImpl::applyThreadContext( sourceInfo.getOutputInfo() );
+		applyContext( sourceInfo.getOutputInfo() );
 		PrivateImpl::updateSourceOptions( sourceInfo );
 		Proxies::alSourceStop( PrivateImpl::querySource( sourceInfo ) );
+		checkErrors( "stopAudio" );
+	}
+}
+
+void prepareSource( const SourceInfo &sourceInfo )
+{
+	if( sourceInfo.isValid() )
+	{
+		QMutexLocker locker( &gMutex );
+		applyContext( sourceInfo.getOutputInfo() );
+		PrivateImpl::querySource( sourceInfo );
+		checkErrors( "prepareSource" );
+	}
+}
+
+void releaseSource( const SourceInfo &sourceInfo )
+{
+	if( sourceInfo.isValid() )
+	{
+		QMutexLocker locker( &gMutex );
+		PrivateImpl::releaseSource( sourceInfo.getId() );
+		checkErrors( "releaseSource" );
 	}
 }
 
@@ -205,8 +291,9 @@ void updateSource( const SourceInfo &sourceInfo )
 	if( sourceInfo.isValid() )
 	{
 		QMutexLocker locker( &gMutex );
-		PrivateImpl::applyThreadContext( sourceInfo.getOutputInfo() );
+		applyContext( sourceInfo.getOutputInfo() );
 		PrivateImpl::updateSourceOptions( sourceInfo );
+		checkErrors( "updateSource" );
 	}
 }
 
@@ -215,9 +302,61 @@ void updateListener( const ListenerInfo &listenerInfo )
 	if( listenerInfo.isValid() )
 	{
 		QMutexLocker locker( &gMutex );
-		PrivateImpl::applyThreadContext( listenerInfo.getOutputInfo() );
+		applyContext( listenerInfo.getOutputInfo() );
 		PrivateImpl::updateListenerOptions( listenerInfo );
+		checkErrors( "updateListener" );
+	}
+}
+
+void beginUpdate( const OutputInfo &outputInfo )
+{
+	gMutex.lock();
+	try
+	{
+		if( gBatchDepth == 0 )
+		{
+			PrivateImpl::selectContext( outputInfo );
+			PrivateImpl::deferUpdates();
+			gBatchOutputInfo = outputInfo;
+			gBatchContext = Proxies::getContext();
+		}
+		gBatchDepth++;
 	}
+	catch( ... )
+	{
+		gMutex.unlock();
+		throw;
+	}
+}
+
+void commitUpdate()
+{
+	if( --gBatchDepth == 0 )
+	{
+		try
+		{
+			// process the updates deferred in the batch's context
+			Proxies::setContext( gBatchContext );
+			PrivateImpl::processUpdates();
+			Proxies::checkErrors( "commitUpdate" );
+		}
+		catch( ... )
+		{
+			gBatchOutputInfo = OutputInfo();
+			gBatchContext = NULL;
+			gMutex.unlock();
+			throw;
+		}
+		gBatchOutputInfo = OutputInfo();
+		gBatchContext = NULL;
+	}
+	gMutex.unlock();
+}
+
+Statistics getStatistics()
+{
+	QMutexLocker locker( &gMutex );
+	return PrivateImpl::getStatistics();
 }
 
 }
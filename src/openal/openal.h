@@ -29,6 +29,7 @@ class OutputInfo;
 class SourceInfo;
 class ListenerInfo;
 class AudioData;
+class Statistics;
 
 /**
  * Resets OpenAL and releases any resources.
@@ -65,7 +66,7 @@ void reset();
  *   1 - Errors only
  *   2 - Warnings and errors
  *   3 - Additional info, warnings and errors
- *   4 - Same as 3 + debug info
+ *   4 - Same as 3 + debug info, also checks errors of each OpenAL call
  *
  * @param logLevel log level to use
  * @return true if logging level changed
@@ -107,6 +108,38 @@ bool setConfigValue( const QString &name, const QString &value );
  */
 void playAudio( const SourceInfo &sourceInfo, const AudioData &audioData );
 
+/**
+ * Plays given audio data in provided source in sync with another source.
+ *
+ * Works like playAudio() but instead of prebuffering the audio data is
+ * delayed to play out at the same time as the audio data last given to the
+ * sync source, which must be a streaming source of the same output. Use this
+ * to crossfade audio from the sync source to the source.
+ *
+ * @param sourceInfo information of the source
+ * @param audioData audio data to stream
+ * @param syncSourceInfo information of the source to sync with
+ */
+void playAudio( const SourceInfo &sourceInfo, const AudioData &audioData, const SourceInfo &syncSourceInfo );
+
+/**
+ * Returns true if playAudio() accepts 32 bit float audio data for sources of
+ * given output.
+ *
+ * @param outputInfo output to check
+ * @return true if float samples are supported
+ */
+bool isFloatFormatSupported( const OutputInfo &outputInfo );
+
+/**
+ * Returns true if sources of given output can play their channels directly
+ * to the matching output channels, see SourceInfo::isDirectChannels().
+ *
+ * @param outputInfo output to check
+ * @return true if direct channels are supported
+ */
+bool isDirectChannelsSupported( const OutputInfo &outputInfo );
+
 /**
  * Stops audio playback.
  *
@@ -119,6 +152,26 @@ void playAudio( const SourceInfo &sourceInfo, const AudioData &audioData );
  */
 void stopAudio( const SourceInfo &sourceInfo );
 
+/**
+ * Prepares audio source for playback.
+ *
+ * Binds a source from the output's pool of pre-allocated sources to given
+ * source info and applies its options, so that the first playAudio() call
+ * doesn't need to create any OpenAL objects.
+ *
+ * @param sourceInfo information of the source
+ */
+void prepareSource( const SourceInfo &sourceInfo );
+
+/**
+ * Releases audio source.
+ *
+ * Stops the source and returns it back to the output's source pool.
+ *
+ * @param sourceInfo information of the source
+ */
+void releaseSource( const SourceInfo &sourceInfo );
+
 /**
  * Modifies audio source's options.
  *
@@ -133,4 +186,36 @@ void updateSource( const SourceInfo &sourceInfo );
  */
 void updateListener( const ListenerInfo &listenerInfo );
 
+/**
+ * Starts a batch of listener and source updates.
+ *
+ * Changes made with updateListener(), updateSource(), playAudio() and
+ * stopAudio() to sources of given output are deferred until commitUpdate() is
+ * called, after which they are applied at once. This prevents the mixer from
+ * rendering audio where e.g. the listener has already moved but the sources
+ * have not.
+ *
+ * The calling thread holds OpenAL's lock until commitUpdate() is called, so
+ * keep the batch short. Every successful call must be paired with a call to
+ * commitUpdate().
+ *
+ * @param outputInfo output whose listener and sources are updated
+ */
+void beginUpdate( const OutputInfo &outputInfo );
+
+/**
+ * Applies changes made after beginUpdate() call.
+ */
+void commitUpdate();
+
+/**
+ * Returns counters collected from OpenAL usage.
+ *
+ * The counters can be used to verify e.g. that streaming audio doesn't
+ * allocate new OpenAL buffers after the sources have warmed up.
+ *
+ * @return statistics object
+ */
+Statistics getStatistics();
+
 }
@@ -21,29 +21,100 @@
 #include "privateimpl.h"
 #include "proxies.h"
 #include "structures.h"
+#include "jittercontroller.h"
 #include "../utils/logging.h"
 
 #include <QVector>
+#include <QQueue>
 #include <QMap>
+#include <QElapsedTimer>
 
 namespace OpenAL {
 namespace PrivateImpl {
 
+struct SourceData
+{
+	SourceData()
+		: source( 0 ), output( -1 ), rolloffFactor( 0 ), relative( false ), streaming( false ), directChannels( false ), sampleRate( 0 )
+	{
+	}
+
+	ALuint source;
+	// handle of the output where the source lies, -1 if the slot is unused
+	int output;
+	// options last applied to the source
+	Entity::Vector position;
+	qreal rolloffFactor;
+	bool relative;
+	bool streaming;
+	bool directChannels;
+	// buffers which have been played through and can be refilled with new
+	// audio data
+	QVector<ALuint> freeBuffers;
+	// all buffers generated for the source, deleted with the source
+	QVector<ALuint> ownedBuffers;
+	// sample frames in each queued stream buffer, oldest first, and sample
+	// rate of the streamed audio
+	QQueue<qint64> queuedFrames;
+	quint32 sampleRate;
+	// sizes silence queued ahead of streamed audio
+	JitterController jitter;
+};
+
+struct OutputData
+{
+	OutputData()
+		: context( NULL )
+	{
+	}
+
+	OutputInfo info;
+	ALCcontext *context;
+	// listener options last applied to the context
+	ListenerInfo listenerInfo;
+	// sources not bound to any source id, generated when context is created
+	QVector<SourceData> sourcePool;
+};
+
 static QMap<QString, ALCdevice*> gOALDevices;
-static QMap<OutputInfo, ALCcontext*> gOALContexts;
-static QMap<OutputInfo, ListenerInfo> gListenerInfos;
-static QMap<quint32, QPair<SourceInfo, ALuint>> gOALSources;
+// indexed by output handle
+static QVector<OutputData> gOutputs;
+// indexed by source id
+static QVector<SourceData> gOALSources;
 static bool gLibraryLoaded = false;
+// -1 until AL_SOFT_deferred_updates support has been checked
+static int gDeferredUpdatesSupported = -1;
+// -1 until AL_EXT_float32 support has been checked
+static int gFloatFormatSupported = -1;
+// -1 until AL_SOFT_direct_channels support has been checked
+static int gDirectChannelsSupported = -1;
+static Statistics gStatistics;
+static QElapsedTimer gClock;
+
+// maximum number of buffers unqueued from a source with one call
+const int UNQUEUE_BATCH_SIZE = 16;
+// sources generated to each context's pool, and buffers for each of them
+const int SOURCE_POOL_SIZE = 64;
+const int POOLED_BUFFER_COUNT = 8;
+// minimum size of the source table, ids below this never grow the table
+const int SOURCE_TABLE_SIZE = 72;
 
 void reset()
 {
 	if( gLibraryLoaded )
 	{
+		Log::info() << "OpenAL stream buffers created: " << QString::number( gStatistics.buffersCreated )
+					<< ", recycled: " << QString::number( gStatistics.buffersRecycled )
+					<< ", underruns: " << QString::number( gStatistics.underruns );
+		gStatistics = Statistics();
 		releaseAllSources();
 		releaseAllContexts();
 		releaseAllDevices();
 		Proxies::unloadLib();
 		gLibraryLoaded = false;
+		gDeferredUpdatesSupported = -1;
+		gFloatFormatSupported = -1;
+		gDirectChannelsSupported = -1;
 	}
 }
 
@@ -96,29 +167,59 @@ ALCdevice *queryDevice( const OutputInfo &info )
 	return gOALDevices[info.getDeviceName()];
 }
 
-ALCcontext *queryContext( const OutputInfo &info )
+int queryOutput( const OutputInfo &info )
 {
 	if( !info.isValid() )
 	{
-		return NULL;
+		return -1;
 	}
-	// create OpenAL context if it doesn't exist yet
-	if( !gOALContexts.contains( info ) )
+	// there are only a few outputs and comparing them compares no strings,
+	// so a linear search is enough
+	for( int handle = 0; handle < gOutputs.size(); handle++ )
 	{
-		ALCint attrs[7] = { 0 };
-		int i = 0;
-		attrs[i++] = ALC_FREQUENCY;
-		attrs[i++] = info.getSampleRate();
-		if( info.isHrtfEnabled() )
+		if( gOutputs[handle].info == info )
 		{
-			attrs[i++] = ALC_FORMAT_CHANNELS_SOFT;
-			attrs[i++] = ALC_STEREO_SOFT;
-			attrs[i++] = ALC_HRTF_SOFT;
-			attrs[i++] = ALC_TRUE;
+			return handle;
 		}
-		gOALContexts[info] = OpenAL::Proxies::alcCreateContext( queryDevice( info ), attrs );
 	}
-	return gOALContexts[info];
+	// create OpenAL context if it doesn't exist yet
+	ALCint attrs[7] = { 0 };
+	int i = 0;
+	attrs[i++] = ALC_FREQUENCY;
+	attrs[i++] = info.getSampleRate();
+	if( info.isHrtfEnabled() )
+	{
+		attrs[i++] = ALC_FORMAT_CHANNELS_SOFT;
+		attrs[i++] = ALC_STEREO_SOFT;
+		attrs[i++] = ALC_HRTF_SOFT;
+		attrs[i++] = ALC_TRUE;
+	}
+	OutputData output;
+	output.info = info;
+	output.context = OpenAL::Proxies::alcCreateContext( queryDevice( info ), attrs );
+	fillSourcePool( output );
+	// voices are positioned relative to the listener, so listener's motion
+	// must not shift their pitch
+	try
+	{
+		OpenAL::Proxies::setContext( output.context );
+		OpenAL::Proxies::alDopplerFactor( 0 );
+	}
+	catch( const OpenAL::Failure &error )
+	{
+		Log::warning() << "Failed to disable doppler effect, reason: " << error.what();
+	}
+	gOutputs.append( output );
+	return gOutputs.size() - 1;
+}
+
+SourceData *findSource( quint32 id )
+{
+	if( id < quint32( gOALSources.size() ) && gOALSources[id].output != -1 )
+	{
+		return &gOALSources[id];
+	}
+	return NULL;
 }
 
 ALuint querySource( const SourceInfo &info )
@@ -127,32 +228,39 @@ ALuint querySource( const SourceInfo &info )
 	{
 		return 0;
 	}
+	const int output = queryOutput( info.getOutputInfo() );
+	const quint32 id = info.getId();
+	if( id >= quint32( gOALSources.size() ) )
+	{
+		gOALSources.resize( qMax<int>( id + 1, SOURCE_TABLE_SIZE ) );
+	}
 	bool createNew = false;
-	if( gOALSources.contains( info.getId() ) )
+	if( gOALSources[id].output != output )
 	{
-		// source already exists
-		SourceInfo prevInfo = gOALSources[info.getId()].first;
-		if( info.getOutputInfo() != prevInfo.getOutputInfo() )
+		if( gOALSources[id].output != -1 )
 		{
 			// changed output info requires new context or device and such a
 			// new source as well
-			releaseSource( info.getId() );
-			createNew = true;
+			releaseSource( id );
+			selectContext( info.getOutputInfo() );
 		}
-	}
-	else
-	{
-		// source doesn't exist --> create a new one
+		QVector<SourceData> &pool = gOutputs[output].sourcePool;
+		SourceData data;
+		if( pool.isEmpty() )
+		{
+			Log::warning() << "OpenAL source pool exhausted, generating a new source";
+			OpenAL::Proxies::alGenSources( 1, &data.source );
+		}
+		else
+		{
+			data = pool.takeLast();
+		}
+		data.output = output;
+		gOALSources[id] = data;
 		createNew = true;
 	}
-	if( createNew )
-	{
-		ALuint source;
-		OpenAL::Proxies::alGenSources( 1, &source );
-		gOALSources[info.getId()] = qMakePair( info, source );
-	}
 	updateSourceOptions( info, createNew );
-	return gOALSources[info.getId()].second;
+	return gOALSources[id].source;
 }
 
 void updateSourceOptions( const SourceInfo &info, bool force )
@@ -161,27 +269,36 @@ void updateSourceOptions( const SourceInfo &info, bool force )
 	{
 		return;
 	}
-	if( gOALSources.contains( info.getId() ) )
+	SourceData *data = findSource( info.getId() );
+	if( data )
 	{
-		SourceInfo prevInfo = gOALSources[info.getId()].first;
-		ALuint source = gOALSources[info.getId()].second;
-		if( force || info.getPosition() != prevInfo.getPosition() )
+		ALuint source = data->source;
+		if( force || info.getPosition() != data->position )
 		{
 			OpenAL::Proxies::alSource3f( source, AL_POSITION, info.getPosition().x, info.getPosition().y, info.getPosition().z );
+			data->position = info.getPosition();
 		}
-		if( force || info.getRolloffFactor() != prevInfo.getRolloffFactor() )
+		if( force || info.getRolloffFactor() != data->rolloffFactor )
 		{
 			OpenAL::Proxies::alSourcef( source, AL_ROLLOFF_FACTOR, info.getRolloffFactor() );
+			data->rolloffFactor = info.getRolloffFactor();
 		}
-		if( force || info.isRelative() != prevInfo.isRelative() )
+		if( force || info.isRelative() != data->relative )
 		{
 			OpenAL::Proxies::alSourcei( source, AL_SOURCE_RELATIVE, info.isRelative()? AL_TRUE: AL_FALSE );
+			data->relative = info.isRelative();
 		}
-		if( force || info.isStreaming() != prevInfo.isStreaming() )
+		if( force || info.isStreaming() != data->streaming )
 		{
 			OpenAL::Proxies::alSourcei( source, AL_LOOPING, info.isStreaming()? AL_FALSE: AL_TRUE );
+			data->streaming = info.isStreaming();
+		}
+		// not forced to off, so that sources work without the extension
+		if( info.isDirectChannels() != data->directChannels && isDirectChannelsSupported() )
+		{
+			OpenAL::Proxies::alSourcei( source, AL_DIRECT_CHANNELS_SOFT, info.isDirectChannels()? AL_TRUE: AL_FALSE );
+			data->directChannels = info.isDirectChannels();
 		}
-		gOALSources[info.getId()].first = info;
 	}
 }
 
@@ -191,14 +308,10 @@ void updateListenerOptions( const ListenerInfo &info )
 	{
 		return;
 	}
-	bool force = false;
-	if( !gListenerInfos.contains( info.getOutputInfo() ) )
-	{
-		gListenerInfos[info.getOutputInfo()] = info;
-		force = true;
-	}
-	ListenerInfo prevInfo = gListenerInfos[info.getOutputInfo()];
-	if( force || info.getForward() != prevInfo.getForward() || info.getUp() != prevInfo.getForward() )
+	OutputData &output = gOutputs[queryOutput( info.getOutputInfo() )];
+	const bool force = !output.listenerInfo.isValid();
+	const ListenerInfo &prevInfo = output.listenerInfo;
+	if( force || info.getForward() != prevInfo.getForward() || info.getUp() != prevInfo.getUp() )
 	{
 		ALfloat orientation[] = { (ALfloat) info.getForward().x, (ALfloat) info.getForward().y, (ALfloat) info.getForward().z,
 								  (ALfloat) info.getUp().x, (ALfloat) info.getUp().y, (ALfloat) info.getUp().z };
@@ -216,24 +329,94 @@ void updateListenerOptions( const ListenerInfo &info )
 	{
 		OpenAL::Proxies::alListener3f( AL_VELOCITY, info.getVelocity().x, info.getVelocity().y, info.getVelocity().z );
 	}
+	output.listenerInfo = info;
+}
+
+void fillSourcePool( OutputData &output )
+{
+	ALuint sources[SOURCE_POOL_SIZE];
+	ALuint buffers[SOURCE_POOL_SIZE * POOLED_BUFFER_COUNT];
+	try
+	{
+		OpenAL::Proxies::setContext( output.context );
+		OpenAL::Proxies::alGenSources( SOURCE_POOL_SIZE, sources );
+		try
+		{
+			OpenAL::Proxies::alGenBuffers( SOURCE_POOL_SIZE * POOLED_BUFFER_COUNT, buffers );
+		}
+		catch( ... )
+		{
+			OpenAL::Proxies::alDeleteSources( SOURCE_POOL_SIZE, sources );
+			throw;
+		}
+	}
+	catch( const OpenAL::Failure &error )
+	{
+		Log::warning() << "Failed to fill OpenAL source pool, reason: " << error.what();
+		return;
+	}
+	output.sourcePool.reserve( SOURCE_POOL_SIZE );
+	for( int i = 0; i < SOURCE_POOL_SIZE; i++ )
+	{
+		SourceData data;
+		data.source = sources[i];
+		for( int j = 0; j < POOLED_BUFFER_COUNT; j++ )
+		{
+			data.ownedBuffers.append( buffers[i * POOLED_BUFFER_COUNT + j] );
+		}
+		data.freeBuffers = data.ownedBuffers;
+		output.sourcePool.append( data );
+	}
+	gStatistics.buffersCreated += SOURCE_POOL_SIZE * POOLED_BUFFER_COUNT;
+}
+
+void releaseSourcePool( OutputData &output )
+{
+	foreach( const SourceData &data, output.sourcePool )
+	{
+		try
+		{
+			OpenAL::Proxies::alDeleteSources( 1, &data.source );
+			if( !data.ownedBuffers.isEmpty() )
+			{
+				OpenAL::Proxies::alDeleteBuffers( data.ownedBuffers.size(), data.ownedBuffers.data() );
+			}
+		}
+		catch( ... )
+		{
+			Log::warning() << "Failed to destroy pooled OpenAL source";
+		}
+	}
+	output.sourcePool.clear();
 }
 
 void releaseAllContexts()
 {
-	OpenAL::Proxies::alcSetThreadContext( NULL );
-	foreach( ALCcontext *context, gOALContexts )
+	for( int handle = 0; handle < gOutputs.size(); handle++ )
 	{
 		try
 		{
-			OpenAL::Proxies::alcDestroyContext( context );
+			OpenAL::Proxies::setContext( gOutputs[handle].context );
+			releaseSourcePool( gOutputs[handle] );
+		}
+		catch( ... )
+		{
+			Log::warning() << "Failed to release OpenAL source pool";
+		}
+	}
+	OpenAL::Proxies::setContext( NULL );
+	foreach( const OutputData &output, gOutputs )
+	{
+		try
+		{
+			OpenAL::Proxies::alcDestroyContext( output.context );
 		}
 		catch( ... )
 		{
 			Log::warning() << "Failed to release OpenAL context ";
 		}
 	}
-	gListenerInfos.clear();
-	gOALContexts.clear();
+	gOutputs.clear();
 }
 
 void releaseAllDevices()
@@ -254,7 +437,7 @@ void releaseAllDevices()
 
 void releaseAllSources()
 {
-	foreach( quint32 id, gOALSources.keys() )
+	for( int id = 0; id < gOALSources.size(); id++ )
 	{
 		releaseSource( id );
 	}
@@ -265,11 +448,22 @@ void releaseSource( quint32 id )
 {
 	try
 	{
-		if( gOALSources.contains( id ) )
+		SourceData *data = findSource( id );
+		if( data )
 		{
-			auto sourceData = gOALSources.take( id );
-			applyThreadContext( sourceData.first.getOutputInfo() );
-			OpenAL::Proxies::alDeleteSources( 1, &sourceData.second );
+			SourceData sourceData = *data;
+			*data = SourceData();
+			OutputData &output = gOutputs[sourceData.output];
+			OpenAL::Proxies::setContext( output.context );
+			// detach any queued buffers and return the source with its
+			// buffers back to the context's pool for reuse
+			OpenAL::Proxies::alSourceStop( sourceData.source );
+			OpenAL::Proxies::alSourcei( sourceData.source, AL_BUFFER, 0 );
+			sourceData.output = -1;
+			sourceData.freeBuffers = sourceData.ownedBuffers;
+			sourceData.queuedFrames.clear();
+			sourceData.jitter = JitterController();
+			output.sourcePool.append( sourceData );
 		}
 	}
 	catch( ... )
@@ -289,6 +483,8 @@ ALenum oalGetFormat( quint16 channels, quint16 samples )
 			return AL_MONO8_SOFT;
 		case 16:
 			return AL_MONO16_SOFT;
+		case 32:
+			return AL_FORMAT_MONO_FLOAT32;
 		default:
 			throw OpenAL::Failure( "Unsupported bits per sample value" );
 		}
@@ -300,6 +496,8 @@ ALenum oalGetFormat( quint16 channels, quint16 samples )
 			return AL_STEREO8_SOFT;
 		case 16:
 			return AL_STEREO16_SOFT;
+		case 32:
+			return AL_FORMAT_STEREO_FLOAT32;
 		default:
 			throw OpenAL::Failure( "Unsupported bits per sample value" );
 		}
@@ -311,14 +509,15 @@ ALenum oalGetFormat( quint16 channels, quint16 samples )
 
 bool isSourcePlaying( const SourceInfo &sourceInfo )
 {
-	ALint state;
+	ALint state = AL_STOPPED;
 	OpenAL::Proxies::alGetSourcei( querySource( sourceInfo ), AL_SOURCE_STATE, &state );
 	return state == AL_PLAYING;
 }
 
-void applyThreadContext( const OutputInfo &info )
+void selectContext( const OutputInfo &info )
 {
-	OpenAL::Proxies::alcSetThreadContext( queryContext( info ) );
+	const int output = queryOutput( info );
+	OpenAL::Proxies::setContext( output == -1? NULL: gOutputs[output].context );
 }
 
 ALuint bufferAudioData( const AudioData &audioData )
@@ -346,24 +545,210 @@ ALuint bufferAudioData( const AudioData &audioData )
 	return buffer;
 }
 
-void cleanupProcessedBuffers( const SourceInfo &sourceInfo )
+ALuint bufferStreamAudioData( const SourceInfo &sourceInfo, const AudioData &audioData )
+{
+	querySource( sourceInfo );
+	SourceData &data = gOALSources[sourceInfo.getId()];
+	ALuint buffer = 0;
+	if( data.freeBuffers.isEmpty() )
+	{
+		OpenAL::Proxies::alGenBuffers( 1, &buffer );
+		data.ownedBuffers.append( buffer );
+		gStatistics.buffersCreated++;
+	}
+	else
+	{
+		buffer = data.freeBuffers.takeLast();
+		gStatistics.buffersRecycled++;
+	}
+	try
+	{
+		ALenum format = oalGetFormat( audioData.getChannelCount(), audioData.getSampleSize() );
+		Proxies::alBufferData( buffer,
+							   format,
+							   audioData.getData(),
+							   audioData.getDataSize(),
+							   audioData.getSampleRate() );
+	}
+	catch( ... )
+	{
+		data.freeBuffers.append( buffer );
+		throw;
+	}
+	return buffer;
+}
+
+void queueStreamBuffer( const SourceInfo &sourceInfo, ALuint buffer, const AudioData &audioData )
+{
+	ALuint source = querySource( sourceInfo );
+	SourceData &data = gOALSources[sourceInfo.getId()];
+	Proxies::alSourceQueueBuffers( source, 1, &buffer );
+	data.queuedFrames.enqueue( audioData.getDataSize() / ( audioData.getChannelCount() * audioData.getSampleSize() / 8 ) );
+	data.sampleRate = audioData.getSampleRate();
+}
+
+void recycleStreamBuffer( const SourceInfo &sourceInfo, ALuint buffer )
+{
+	SourceData *data = findSource( sourceInfo.getId() );
+	if( data )
+	{
+		data->freeBuffers.append( buffer );
+	}
+}
+
+void recycleProcessedBuffers( const SourceInfo &sourceInfo )
 {
 	try
 	{
 		ALuint source = querySource( sourceInfo );
+		SourceData &data = gOALSources[sourceInfo.getId()];
 		ALint processedCount = 0;
 		OpenAL::Proxies::alGetSourcei( source, AL_BUFFERS_PROCESSED, &processedCount );
-		if( processedCount > 0 )
+		while( processedCount > 0 )
 		{
-			QVector<ALuint> buffers( processedCount );
-			Proxies::alSourceUnqueueBuffers( source, buffers.size(), buffers.data() );
-			Proxies::alDeleteBuffers( buffers.size(), buffers.data() );
+			ALuint buffers[UNQUEUE_BATCH_SIZE];
+			ALsizei count = qMin<ALint>( processedCount, UNQUEUE_BATCH_SIZE );
+			Proxies::alSourceUnqueueBuffers( source, count, buffers );
+			for( int i = 0; i < count; i++ )
+			{
+				data.freeBuffers.append( buffers[i] );
+				if( !data.queuedFrames.isEmpty() )
+				{
+					data.queuedFrames.dequeue();
+				}
+			}
+			processedCount -= count;
 		}
 	}
 	catch( const OpenAL::Failure &error )
 	{
-		Log::warning() << "Failed to clean up processed buffers, reason: " << error.what();
+		Log::warning() << "Failed to recycle processed buffers, reason: " << error.what();
+	}
+}
+
+bool isFloatFormatSupported()
+{
+	if( gFloatFormatSupported == -1 )
+	{
+		gFloatFormatSupported = Proxies::alIsExtensionPresent( "AL_EXT_float32" )? 1: 0;
+	}
+	return gFloatFormatSupported;
+}
+
+bool isDirectChannelsSupported()
+{
+	if( gDirectChannelsSupported == -1 )
+	{
+		gDirectChannelsSupported = Proxies::alIsExtensionPresent( "AL_SOFT_direct_channels" )? 1: 0;
+		if( !gDirectChannelsSupported )
+		{
+			Log::info() << "AL_SOFT_direct_channels not supported, positioning all voices with HRTF";
+		}
 	}
+	return gDirectChannelsSupported;
+}
+
+bool isDeferredUpdatesSupported()
+{
+	if( gDeferredUpdatesSupported == -1 )
+	{
+		gDeferredUpdatesSupported = Proxies::alIsExtensionPresent( "AL_SOFT_deferred_updates" )? 1: 0;
+		if( !gDeferredUpdatesSupported )
+		{
+			Log::info() << "AL_SOFT_deferred_updates not supported, suspending context instead";
+		}
+	}
+	return gDeferredUpdatesSupported;
+}
+
+void deferUpdates()
+{
+	if( isDeferredUpdatesSupported() )
+	{
+		Proxies::alDeferUpdatesSOFT();
+	}
+	else
+	{
+		Proxies::alcSuspendContext( Proxies::getContext() );
+	}
+}
+
+void processUpdates()
+{
+	if( isDeferredUpdatesSupported() )
+	{
+		Proxies::alProcessUpdatesSOFT();
+	}
+	else
+	{
+		Proxies::alcProcessContext( Proxies::getContext() );
+	}
+}
+
+/**
+ * Returns duration of audio queued to the source but not yet played, in
+ * milliseconds, or zero if the source is not playing.
+ */
+qreal queryQueuedDuration( const SourceData &data )
+{
+	ALint state = AL_STOPPED;
+	OpenAL::Proxies::alGetSourcei( data.source, AL_SOURCE_STATE, &state );
+	if( state != AL_PLAYING || data.sampleRate == 0 )
+	{
+		return 0;
+	}
+	// sample offset counts from start of the queue, which includes any
+	// processed buffers not yet unqueued as does the queued frame count
+	ALint sampleOffset = 0;
+	OpenAL::Proxies::alGetSourcei( data.source, AL_SAMPLE_OFFSET, &sampleOffset );
+	qint64 queuedFrames = -sampleOffset;
+	foreach( qint64 frames, data.queuedFrames )
+	{
+		queuedFrames += frames;
+	}
+	return qMax<qint64>( 0, queuedFrames ) * 1000.0 / data.sampleRate;
+}
+
+qreal queryPrebufferDuration( const SourceInfo &sourceInfo, const AudioData &audioData, bool isPlaying, const SourceInfo &syncSourceInfo )
+{
+	if( !gClock.isValid() )
+	{
+		gClock.start();
+	}
+	querySource( sourceInfo );
+	SourceData &data = gOALSources[sourceInfo.getId()];
+	const quint32 frameSize = audioData.getChannelCount() * audioData.getSampleSize() / 8;
+	const qreal duration = audioData.getDataSize() / frameSize * 1000.0 / audioData.getSampleRate();
+	const bool burstStarted = data.jitter.packetReceived( gClock.elapsed(), duration );
+	const qreal queuedDuration = isPlaying? queryQueuedDuration( data ): 0;
+	if( isPlaying )
+	{
+		data.jitter.queueDepthMeasured( queuedDuration );
+	}
+	SourceData *syncData = syncSourceInfo.isValid()? findSource( syncSourceInfo.getId() ): NULL;
+	if( syncData && syncData->output == data.output )
+	{
+		// the audio moves over from the sync source, whose queue holds this
+		// packet's audio already, so line the packet up with it instead of
+		// prebuffering, the sync source draining is not an underrun either
+		syncData->jitter.burstEnded();
+		return qMax<qreal>( 0, queryQueuedDuration( *syncData ) - duration - queuedDuration );
+	}
+	if( isPlaying )
+	{
+		return 0;
+	}
+	if( !burstStarted )
+	{
+		data.jitter.underrun();
+		gStatistics.underruns++;
+	}
+	return data.jitter.getPrebufferDuration();
+}
+
+Statistics getStatistics()
+{
+	return gStatistics;
 }
 
 }
@@ -28,24 +28,41 @@ class OutputInfo;
 class SourceInfo;
 class ListenerInfo;
 class AudioData;
+class Statistics;
 
 namespace PrivateImpl {
 
+struct SourceData;
+struct OutputData;
+
 void reset();
 ALenum oalGetFormat( quint16 channels, quint16 samples );
 ALCdevice *queryDevice( const OutputInfo &info );
-ALCcontext *queryContext( const OutputInfo &info );
+int queryOutput( const OutputInfo &info );
+SourceData *findSource( quint32 id );
 ALuint querySource( const SourceInfo &info );
 void updateSourceOptions( const SourceInfo &info, bool force = false );
 void updateListenerOptions( const ListenerInfo &info );
+void fillSourcePool( OutputData &output );
+void releaseSourcePool( OutputData &output );
 void releaseAllContexts();
 void releaseAllDevices();
 void releaseAllSources();
 void releaseSource( quint32 id );
-void applyThreadContext( const OutputInfo &info );
+void selectContext( const OutputInfo &info );
 ALuint bufferAudioData( const AudioData &audioData );
-void cleanupProcessedBuffers( const SourceInfo &sourceInfo );
+ALuint bufferStreamAudioData( const SourceInfo &sourceInfo, const AudioData &audioData );
+void queueStreamBuffer( const SourceInfo &sourceInfo, ALuint buffer, const AudioData &audioData );
+void recycleStreamBuffer( const SourceInfo &sourceInfo, ALuint buffer );
+void recycleProcessedBuffers( const SourceInfo &sourceInfo );
+qreal queryQueuedDuration( const SourceData &data );
+qreal queryPrebufferDuration( const SourceInfo &sourceInfo, const AudioData &audioData, bool isPlaying, const SourceInfo &syncSourceInfo );
 bool isSourcePlaying( const SourceInfo &sourceInfo );
+bool isFloatFormatSupported();
+bool isDirectChannelsSupported();
+void deferUpdates();
+void processUpdates();
+Statistics getStatistics();
 
 }
 }
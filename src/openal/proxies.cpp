@@ -22,14 +22,43 @@
 #include "structures.h"
 #include "../utils/logging.h"
 
+#include <AL/alext.h>
+#include <QAtomicInt>
+
 #ifdef WIN32
 #include <Windows.h>
 #else
 #include <dlfcn.h>
 #endif
 
+#include <algorithm>
 #include <iostream>
 
+// entry points of ALC_EXT_direct_context which take the context as first
+// argument instead of using the current context, not in bundled headers
+typedef const ALchar* (AL_APIENTRY *LPALGETSTRINGDIRECT)( ALCcontext*, ALenum );
+typedef ALenum (AL_APIENTRY *LPALGETERRORDIRECT)( ALCcontext* );
+typedef void (AL_APIENTRY *LPALLISTENERFDIRECT)( ALCcontext*, ALenum, ALfloat );
+typedef void (AL_APIENTRY *LPALDOPPLERFACTORDIRECT)( ALCcontext*, ALfloat );
+typedef void (AL_APIENTRY *LPALLISTENER3FDIRECT)( ALCcontext*, ALenum, ALfloat, ALfloat, ALfloat );
+typedef void (AL_APIENTRY *LPALLISTENERFVDIRECT)( ALCcontext*, ALenum, const ALfloat* );
+typedef void (AL_APIENTRY *LPALGENSOURCESDIRECT)( ALCcontext*, ALsizei, ALuint* );
+typedef void (AL_APIENTRY *LPALDELETESOURCESDIRECT)( ALCcontext*, ALsizei, const ALuint* );
+typedef void (AL_APIENTRY *LPALSOURCEFDIRECT)( ALCcontext*, ALuint, ALenum, ALfloat );
+typedef void (AL_APIENTRY *LPALSOURCE3FDIRECT)( ALCcontext*, ALuint, ALenum, ALfloat, ALfloat, ALfloat );
+typedef void (AL_APIENTRY *LPALSOURCEIDIRECT)( ALCcontext*, ALuint, ALenum, ALint );
+typedef void (AL_APIENTRY *LPALGETSOURCEIDIRECT)( ALCcontext*, ALuint, ALenum, ALint* );
+typedef void (AL_APIENTRY *LPALBUFFERDATADIRECT)( ALCcontext*, ALuint, ALenum, const ALvoid*, ALsizei, ALsizei );
+typedef void (AL_APIENTRY *LPALDELETEBUFFERSDIRECT)( ALCcontext*, ALsizei, const ALuint* );
+typedef void (AL_APIENTRY *LPALGENBUFFERSDIRECT)( ALCcontext*, ALsizei, ALuint* );
+typedef void (AL_APIENTRY *LPALSOURCEUNQUEUEBUFFERSDIRECT)( ALCcontext*, ALuint, ALsizei, ALuint* );
+typedef void (AL_APIENTRY *LPALSOURCEQUEUEBUFFERSDIRECT)( ALCcontext*, ALuint, ALsizei, const ALuint* );
+typedef void (AL_APIENTRY *LPALSOURCEPLAYDIRECT)( ALCcontext*, ALuint );
+typedef void (AL_APIENTRY *LPALSOURCESTOPDIRECT)( ALCcontext*, ALuint );
+typedef ALboolean (AL_APIENTRY *LPALISEXTENSIONPRESENTDIRECT)( ALCcontext*, const ALchar* );
+typedef void (AL_APIENTRY *LPALDEFERUPDATESDIRECTSOFT)( ALCcontext* );
+typedef void (AL_APIENTRY *LPALPROCESSUPDATESDIRECTSOFT)( ALCcontext* );
+
 namespace
 {
 
@@ -46,11 +75,39 @@ LPALSOURCESTOP           g_alSourceStop;
 LPALSOURCEQUEUEBUFFERS   g_alSourceQueueBuffers;
 LPALLISTENER3F           g_alListener3f;
 LPALLISTENERF            g_alListenerf;
+LPALDOPPLERFACTOR        g_alDopplerFactor;
 LPALLISTENERFV           g_alListenerfv;
 LPALSOURCE3F             g_alSource3f;
 LPALSOURCEF              g_alSourcef;
 LPALSOURCEI              g_alSourcei;
 LPALSOURCEUNQUEUEBUFFERS g_alSourceUnqueueBuffers;
+LPALISEXTENSIONPRESENT   g_alIsExtensionPresent;
+LPALGETPROCADDRESS       g_alGetProcAddress;
+// extension functions, null if not supported by the library
+LPALDEFERUPDATESSOFT     g_alDeferUpdatesSOFT;
+LPALPROCESSUPDATESSOFT   g_alProcessUpdatesSOFT;
+LPALGETSTRINGDIRECT            g_alGetStringDirect;
+LPALGETERRORDIRECT             g_alGetErrorDirect;
+LPALLISTENERFDIRECT            g_alListenerfDirect;
+LPALDOPPLERFACTORDIRECT        g_alDopplerFactorDirect;
+LPALLISTENER3FDIRECT           g_alListener3fDirect;
+LPALLISTENERFVDIRECT           g_alListenerfvDirect;
+LPALGENSOURCESDIRECT           g_alGenSourcesDirect;
+LPALDELETESOURCESDIRECT        g_alDeleteSourcesDirect;
+LPALSOURCEFDIRECT              g_alSourcefDirect;
+LPALSOURCE3FDIRECT             g_alSource3fDirect;
+LPALSOURCEIDIRECT              g_alSourceiDirect;
+LPALGETSOURCEIDIRECT           g_alGetSourceiDirect;
+LPALBUFFERDATADIRECT           g_alBufferDataDirect;
+LPALDELETEBUFFERSDIRECT        g_alDeleteBuffersDirect;
+LPALGENBUFFERSDIRECT           g_alGenBuffersDirect;
+LPALSOURCEUNQUEUEBUFFERSDIRECT g_alSourceUnqueueBuffersDirect;
+LPALSOURCEQUEUEBUFFERSDIRECT   g_alSourceQueueBuffersDirect;
+LPALSOURCEPLAYDIRECT           g_alSourcePlayDirect;
+LPALSOURCESTOPDIRECT           g_alSourceStopDirect;
+LPALISEXTENSIONPRESENTDIRECT   g_alIsExtensionPresentDirect;
+LPALDEFERUPDATESDIRECTSOFT     g_alDeferUpdatesDirectSOFT;
+LPALPROCESSUPDATESDIRECTSOFT   g_alProcessUpdatesDirectSOFT;
 
 LPALCOPENDEVICE          g_alcOpenDevice;
 LPALCCREATECONTEXT       g_alcCreateContext;
@@ -61,6 +118,24 @@ LPALCCLOSEDEVICE         g_alcCloseDevice;
 LPALCGETINTEGERV         g_alcGetIntegerv;
 LPALCGETERROR            g_alcGetError;
 LPALCGETSTRING           g_alcGetString;
+LPALCSUSPENDCONTEXT      g_alcSuspendContext;
+LPALCPROCESSCONTEXT      g_alcProcessContext;
+LPALCISEXTENSIONPRESENT  g_alcIsExtensionPresent;
+LPALCGETPROCADDRESS      g_alcGetProcAddress;
+
+// true when al-prefixed calls are dispatched with *Direct entry points
+bool g_directContextSupported = false;
+// context which al-prefixed calls target, see OpenAL::Proxies::setContext()
+ALCcontext *g_context = NULL;
+// context last made current on each thread when direct dispatch is not
+// supported, generation invalidates the cache when any context is destroyed
+QAtomicInt g_contextGeneration;
+thread_local ALCcontext *t_threadContext = NULL;
+thread_local int t_threadContextGeneration = -1;
+
+OpenAL::Proxies::ErrorCheckMode g_errorCheckMode = OPENAL_ERROR_CHECK_MODE;
+// error of the current batch taken before an always checked call
+ALenum g_batchError = AL_NO_ERROR;
 
 #ifdef WIN32
 HMODULE g_openALLib = NULL;
@@ -68,6 +143,17 @@ HMODULE g_openALLib = NULL;
 void *g_openALLib = NULL;
 #endif
 
+template <typename TFunction>
+TFunction resolveDirectSymbol( const char *symbol )
+{
+	TFunction result = (TFunction) g_alcGetProcAddress( NULL, symbol );
+	if( !result )
+	{
+		g_directContextSupported = false;
+	}
+	return result;
+}
+
 template <typename TFunction>
 TFunction resolveSymbol( const char *symbol )
 {
@@ -112,15 +198,67 @@ QString getWin32ErrorMessage()
 }
 #endif
 
-void testForALError( const char *funcName )
+void throwALError( const char *funcName, ALenum err )
 {
-	ALenum err = OpenAL::Proxies::alGetError();
 	if( err != AL_NO_ERROR )
 	{
 		throw OpenAL::Failure( QString( "%1() failed, err=%2, text=%3" ).arg( funcName ).arg( err ).arg( OpenAL::Proxies::alGetString( err ) ) );
 	}
 }
 
+void throwOnALError( const char *funcName )
+{
+	throwALError( funcName, OpenAL::Proxies::alGetError() );
+}
+
+// checks errors of calls whose failure leaves no invalid objects behind,
+// calls which create or return objects use the functions below
+void testForALError( const char *funcName )
+{
+	if( g_errorCheckMode == OpenAL::Proxies::CheckPerCall )
+	{
+		throwOnALError( funcName );
+	}
+}
+
+// takes error state left by unchecked calls before a call which is always
+// checked, so that the call isn't blamed for them, in batch mode the error
+// is kept for checkErrors()
+void takeEarlierALError()
+{
+	if( g_errorCheckMode == OpenAL::Proxies::CheckOff )
+	{
+		return;
+	}
+	ALenum err = OpenAL::Proxies::alGetError();
+	if( g_errorCheckMode == OpenAL::Proxies::CheckPerBatch && g_batchError == AL_NO_ERROR )
+	{
+		g_batchError = err;
+	}
+}
+
+// checks a call which creates or returns objects, unless errors are off
+void testForALErrorAlways( const char *funcName )
+{
+	if( g_errorCheckMode != OpenAL::Proxies::CheckOff )
+	{
+		throwOnALError( funcName );
+	}
+}
+
+// a failed generation leaves names untouched, so names which are still
+// zero tell of failure without reading the error state
+void testForGeneratedNames( const char *funcName, ALsizei n, const ALuint *names )
+{
+	for( ALsizei i = 0; i < n; i++ )
+	{
+		if( names[i] == 0 )
+		{
+			throw OpenAL::Failure( QString( "%1() failed to generate names" ).arg( funcName ) );
+		}
+	}
+}
+
 void testForALCError( ALCdevice *device, const char *funcName )
 {
 	ALCenum err = OpenAL::Proxies::alcGetError( device );
@@ -138,6 +276,36 @@ namespace OpenAL
 namespace Proxies
 {
 
+ErrorCheckMode getDefaultErrorCheckMode()
+{
+	return OPENAL_ERROR_CHECK_MODE;
+}
+
+void setErrorCheckMode( ErrorCheckMode mode )
+{
+	g_errorCheckMode = mode;
+	g_batchError = AL_NO_ERROR;
+}
+
+ErrorCheckMode getErrorCheckMode()
+{
+	return g_errorCheckMode;
+}
+
+void checkErrors( const char *batchName )
+{
+	if( g_errorCheckMode == CheckPerBatch && g_openALLib )
+	{
+		ALenum err = g_batchError;
+		g_batchError = AL_NO_ERROR;
+		if( err == AL_NO_ERROR )
+		{
+			err = alGetError();
+		}
+		throwALError( batchName, err );
+	}
+}
+
 void loadLib()
 {
 	if( !g_openALLib )
@@ -175,11 +343,14 @@ void loadLib()
 		g_alSourceQueueBuffers   = resolveSymbol<LPALSOURCEQUEUEBUFFERS>( "alSourceQueueBuffers" );
 		g_alListener3f           = resolveSymbol<LPALLISTENER3F>( "alListener3f" );
 		g_alListenerf            = resolveSymbol<LPALLISTENERF>( "alListenerf" );
+		g_alDopplerFactor        = resolveSymbol<LPALDOPPLERFACTOR>( "alDopplerFactor" );
 		g_alListenerfv           = resolveSymbol<LPALLISTENERFV>( "alListenerfv" );
 		g_alSource3f             = resolveSymbol<LPALSOURCE3F>( "alSource3f" );
 		g_alSourcef              = resolveSymbol<LPALSOURCEF>( "alSourcef" );
 		g_alSourcei              = resolveSymbol<LPALSOURCEI>( "alSourcei" );
 		g_alSourceUnqueueBuffers = resolveSymbol<LPALSOURCEUNQUEUEBUFFERS>( "alSourceUnqueueBuffers" );
+		g_alIsExtensionPresent   = resolveSymbol<LPALISEXTENSIONPRESENT>( "alIsExtensionPresent" );
+		g_alGetProcAddress       = resolveSymbol<LPALGETPROCADDRESS>( "alGetProcAddress" );
 		g_alcOpenDevice          = resolveSymbol<LPALCOPENDEVICE>( "alcOpenDevice" );
 		g_alcCreateContext       = resolveSymbol<LPALCCREATECONTEXT>( "alcCreateContext" );
 		g_alcSetThreadContext    = resolveSymbol<LPALCMAKECONTEXTCURRENT>( "alcSetThreadContext" );
@@ -189,6 +360,42 @@ void loadLib()
 		g_alcGetIntegerv         = resolveSymbol<LPALCGETINTEGERV>( "alcGetIntegerv" );
 		g_alcGetError            = resolveSymbol<LPALCGETERROR>( "alcGetError" );
 		g_alcGetString           = resolveSymbol<LPALCGETSTRING>( "alcGetString" );
+		g_alcSuspendContext      = resolveSymbol<LPALCSUSPENDCONTEXT>( "alcSuspendContext" );
+		g_alcProcessContext      = resolveSymbol<LPALCPROCESSCONTEXT>( "alcProcessContext" );
+		g_alcIsExtensionPresent  = resolveSymbol<LPALCISEXTENSIONPRESENT>( "alcIsExtensionPresent" );
+		g_alcGetProcAddress      = resolveSymbol<LPALCGETPROCADDRESS>( "alcGetProcAddress" );
+
+		g_alDeferUpdatesSOFT     = (LPALDEFERUPDATESSOFT) g_alGetProcAddress( "alDeferUpdatesSOFT" );
+		g_alProcessUpdatesSOFT   = (LPALPROCESSUPDATESSOFT) g_alGetProcAddress( "alProcessUpdatesSOFT" );
+
+		// use direct dispatch only if every needed entry point is available
+		g_directContextSupported = g_alcIsExtensionPresent( NULL, "ALC_EXT_direct_context" ) == ALC_TRUE;
+		if( g_directContextSupported )
+		{
+			g_alGetStringDirect            = resolveDirectSymbol<LPALGETSTRINGDIRECT>( "alGetStringDirect" );
+			g_alGetErrorDirect             = resolveDirectSymbol<LPALGETERRORDIRECT>( "alGetErrorDirect" );
+			g_alListenerfDirect            = resolveDirectSymbol<LPALLISTENERFDIRECT>( "alListenerfDirect" );
+			g_alDopplerFactorDirect        = resolveDirectSymbol<LPALDOPPLERFACTORDIRECT>( "alDopplerFactorDirect" );
+			g_alListener3fDirect           = resolveDirectSymbol<LPALLISTENER3FDIRECT>( "alListener3fDirect" );
+			g_alListenerfvDirect           = resolveDirectSymbol<LPALLISTENERFVDIRECT>( "alListenerfvDirect" );
+			g_alGenSourcesDirect           = resolveDirectSymbol<LPALGENSOURCESDIRECT>( "alGenSourcesDirect" );
+			g_alDeleteSourcesDirect        = resolveDirectSymbol<LPALDELETESOURCESDIRECT>( "alDeleteSourcesDirect" );
+			g_alSourcefDirect              = resolveDirectSymbol<LPALSOURCEFDIRECT>( "alSourcefDirect" );
+			g_alSource3fDirect             = resolveDirectSymbol<LPALSOURCE3FDIRECT>( "alSource3fDirect" );
+			g_alSourceiDirect              = resolveDirectSymbol<LPALSOURCEIDIRECT>( "alSourceiDirect" );
+			g_alGetSourceiDirect           = resolveDirectSymbol<LPALGETSOURCEIDIRECT>( "alGetSourceiDirect" );
+			g_alBufferDataDirect           = resolveDirectSymbol<LPALBUFFERDATADIRECT>( "alBufferDataDirect" );
+			g_alDeleteBuffersDirect        = resolveDirectSymbol<LPALDELETEBUFFERSDIRECT>( "alDeleteBuffersDirect" );
+			g_alGenBuffersDirect           = resolveDirectSymbol<LPALGENBUFFERSDIRECT>( "alGenBuffersDirect" );
+			g_alSourceUnqueueBuffersDirect = resolveDirectSymbol<LPALSOURCEUNQUEUEBUFFERSDIRECT>( "alSourceUnqueueBuffersDirect" );
+			g_alSourceQueueBuffersDirect   = resolveDirectSymbol<LPALSOURCEQUEUEBUFFERSDIRECT>( "alSourceQueueBuffersDirect" );
+			g_alSourcePlayDirect           = resolveDirectSymbol<LPALSOURCEPLAYDIRECT>( "alSourcePlayDirect" );
+			g_alSourceStopDirect           = resolveDirectSymbol<LPALSOURCESTOPDIRECT>( "alSourceStopDirect" );
+			g_alIsExtensionPresentDirect   = resolveDirectSymbol<LPALISEXTENSIONPRESENTDIRECT>( "alIsExtensionPresentDirect" );
+			g_alDeferUpdatesDirectSOFT     = resolveDirectSymbol<LPALDEFERUPDATESDIRECTSOFT>( "alDeferUpdatesDirectSOFT" );
+			g_alProcessUpdatesDirectSOFT   = resolveDirectSymbol<LPALPROCESSUPDATESDIRECTSOFT>( "alProcessUpdatesDirectSOFT" );
+		}
+		Log::info() << ( g_directContextSupported? "Using direct context OpenAL calls": "Using thread context OpenAL calls" );
 	}
 }
 
@@ -209,132 +416,364 @@ void unloadLib()
 		}
 		#endif
 		g_openALLib = NULL;
+		g_directContextSupported = false;
+		g_context = NULL;
+		g_contextGeneration.fetchAndAddOrdered( 1 );
+	}
+}
+
+void setContext( ALCcontext *context )
+{
+	throwIfNotLoaded();
+	g_context = context;
+	if( g_directContextSupported )
+	{
+		return;
+	}
+	// avoid switching thread context if it is current already
+	const int generation = g_contextGeneration.load();
+	if( t_threadContext != context || t_threadContextGeneration != generation )
+	{
+		if( g_alcSetThreadContext( context ) == ALC_FALSE )
+		{
+			throw OpenAL::Failure( "alcSetThreadContext() failed" );
+		}
+		t_threadContext = context;
+		t_threadContextGeneration = generation;
 	}
 }
 
+ALCcontext *getContext()
+{
+	return g_context;
+}
+
+bool isDirectContextSupported()
+{
+	return g_directContextSupported;
+}
+
 const ALchar *alGetString( ALenum param )
 {
 	throwIfNotLoaded();
+	if( g_directContextSupported )
+	{
+		return g_alGetStringDirect( g_context, param );
+	}
 	return g_alGetString( param );
 }
 
 ALenum alGetError()
 {
 	throwIfNotLoaded();
+	if( g_directContextSupported )
+	{
+		return g_alGetErrorDirect( g_context );
+	}
 	return g_alGetError();
 }
 
 void alListenerf( ALenum param, ALfloat value )
 {
 	throwIfNotLoaded();
-	g_alListenerf( param, value );
+	if( g_directContextSupported )
+	{
+		g_alListenerfDirect( g_context, param, value );
+	}
+	else
+	{
+		g_alListenerf( param, value );
+	}
 	testForALError( "alListenerf" );
 }
 
+void alDopplerFactor( ALfloat value )
+{
+	throwIfNotLoaded();
+	if( g_directContextSupported )
+	{
+		g_alDopplerFactorDirect( g_context, value );
+	}
+	else
+	{
+		g_alDopplerFactor( value );
+	}
+	testForALError( "alDopplerFactor" );
+}
+
 void alListener3f( ALenum param, ALfloat value1, ALfloat value2, ALfloat value3 )
 {
 	throwIfNotLoaded();
-	g_alListener3f( param, value1, value2, value3 );
+	if( g_directContextSupported )
+	{
+		g_alListener3fDirect( g_context, param, value1, value2, value3 );
+	}
+	else
+	{
+		g_alListener3f( param, value1, value2, value3 );
+	}
 	testForALError( "alListener3f" );
 }
 
 void alListenerfv( ALenum param, const ALfloat *values )
 {
 	throwIfNotLoaded();
-	g_alListenerfv( param, values );
+	if( g_directContextSupported )
+	{
+		g_alListenerfvDirect( g_context, param, values );
+	}
+	else
+	{
+		g_alListenerfv( param, values );
+	}
 	testForALError( "alListenerfv" );
 }
 
 void alGenSources( ALsizei n, ALuint *sources )
 {
 	throwIfNotLoaded();
-	g_alGenSources( n, sources );
-	testForALError( "alGenSources" );
+	takeEarlierALError();
+	std::fill( sources, sources + n, 0 );
+	if( g_directContextSupported )
+	{
+		g_alGenSourcesDirect( g_context, n, sources );
+	}
+	else
+	{
+		g_alGenSources( n, sources );
+	}
+	testForALErrorAlways( "alGenSources" );
+	testForGeneratedNames( "alGenSources", n, sources );
 }
 
 void alDeleteSources( ALsizei n, const ALuint *sources )
 {
 	throwIfNotLoaded();
-	g_alDeleteSources( n, sources );
+	if( g_directContextSupported )
+	{
+		g_alDeleteSourcesDirect( g_context, n, sources );
+	}
+	else
+	{
+		g_alDeleteSources( n, sources );
+	}
 	testForALError( "alDeleteSources" );
 }
 
 void alSourcef( ALuint source, ALenum param, ALfloat value )
 {
 	throwIfNotLoaded();
-	g_alSourcef( source, param, value );
+	if( g_directContextSupported )
+	{
+		g_alSourcefDirect( g_context, source, param, value );
+	}
+	else
+	{
+		g_alSourcef( source, param, value );
+	}
 	testForALError( "alSourcef" );
 }
 
 void alSource3f( ALuint source, ALenum param, ALfloat value1, ALfloat value2, ALfloat value3 )
 {
 	throwIfNotLoaded();
-	g_alSource3f( source, param, value1, value2, value3 );
+	if( g_directContextSupported )
+	{
+		g_alSource3fDirect( g_context, source, param, value1, value2, value3 );
+	}
+	else
+	{
+		g_alSource3f( source, param, value1, value2, value3 );
+	}
 	testForALError( "alSource3f" );
 }
 
 void alSourcei( ALuint source, ALenum param, ALint value )
 {
 	throwIfNotLoaded();
-	g_alSourcei( source, param, value );
+	if( g_directContextSupported )
+	{
+		g_alSourceiDirect( g_context, source, param, value );
+	}
+	else
+	{
+		g_alSourcei( source, param, value );
+	}
 	testForALError( "alSourcei" );
 }
 
 void alGetSourcei( ALuint source, ALenum param, ALint *value )
 {
 	throwIfNotLoaded();
-	g_alGetSourcei( source, param, value );
+	if( g_directContextSupported )
+	{
+		g_alGetSourceiDirect( g_context, source, param, value );
+	}
+	else
+	{
+		g_alGetSourcei( source, param, value );
+	}
 }
 
 void alBufferData( ALuint buffer, ALenum format, const ALvoid *data, ALsizei size, ALsizei freq )
 {
 	throwIfNotLoaded();
-	g_alBufferData( buffer, format, data, size, freq );
+	if( g_directContextSupported )
+	{
+		g_alBufferDataDirect( g_context, buffer, format, data, size, freq );
+	}
+	else
+	{
+		g_alBufferData( buffer, format, data, size, freq );
+	}
 	testForALError( "alBufferData" );
 }
 
 void alDeleteBuffers( ALsizei n, const ALuint *buffers )
 {
 	throwIfNotLoaded();
-	g_alDeleteBuffers( n, buffers );
+	if( g_directContextSupported )
+	{
+		g_alDeleteBuffersDirect( g_context, n, buffers );
+	}
+	else
+	{
+		g_alDeleteBuffers( n, buffers );
+	}
 	testForALError( "alDeleteBuffers" );
 }
 
 void alGenBuffers( ALsizei n, ALuint *buffers )
 {
 	throwIfNotLoaded();
-	g_alGenBuffers( n, buffers );
-	testForALError( "alGenBuffers" );
+	takeEarlierALError();
+	std::fill( buffers, buffers + n, 0 );
+	if( g_directContextSupported )
+	{
+		g_alGenBuffersDirect( g_context, n, buffers );
+	}
+	else
+	{
+		g_alGenBuffers( n, buffers );
+	}
+	testForALErrorAlways( "alGenBuffers" );
+	testForGeneratedNames( "alGenBuffers", n, buffers );
 }
 
 void alSourceUnqueueBuffers( ALuint source, ALsizei nb, ALuint *buffers )
 {
 	throwIfNotLoaded();
-	g_alSourceUnqueueBuffers( source, nb, buffers );
-	testForALError( "alSourceUnqueueBuffers" );
+	takeEarlierALError();
+	std::fill( buffers, buffers + nb, 0 );
+	if( g_directContextSupported )
+	{
+		g_alSourceUnqueueBuffersDirect( g_context, source, nb, buffers );
+	}
+	else
+	{
+		g_alSourceUnqueueBuffers( source, nb, buffers );
+	}
+	testForALErrorAlways( "alSourceUnqueueBuffers" );
+	testForGeneratedNames( "alSourceUnqueueBuffers", nb, buffers );
 }
 
 void alSourceQueueBuffers( ALuint source, ALsizei nb, const ALuint *buffers )
 {
 	throwIfNotLoaded();
-	g_alSourceQueueBuffers( source, nb, buffers );
+	if( g_directContextSupported )
+	{
+		g_alSourceQueueBuffersDirect( g_context, source, nb, buffers );
+	}
+	else
+	{
+		g_alSourceQueueBuffers( source, nb, buffers );
+	}
 	testForALError( "alSourceQueueBuffers" );
 }
 
 void alSourcePlay( ALuint source )
 {
 	throwIfNotLoaded();
-	g_alSourcePlay( source );
+	if( g_directContextSupported )
+	{
+		g_alSourcePlayDirect( g_context, source );
+	}
+	else
+	{
+		g_alSourcePlay( source );
+	}
 	testForALError( "alSourcePlay" );
 }
 
 void alSourceStop( ALuint source )
 {
 	throwIfNotLoaded();
-	g_alSourceStop( source );
+	if( g_directContextSupported )
+	{
+		g_alSourceStopDirect( g_context, source );
+	}
+	else
+	{
+		g_alSourceStop( source );
+	}
 	testForALError( "alSourceStop" );
 }
 
+ALboolean alIsExtensionPresent( const ALchar *extname )
+{
+	throwIfNotLoaded();
+	takeEarlierALError();
+	ALboolean result;
+	if( g_directContextSupported )
+	{
+		result = g_alIsExtensionPresentDirect( g_context, extname );
+	}
+	else
+	{
+		result = g_alIsExtensionPresent( extname );
+	}
+	testForALErrorAlways( "alIsExtensionPresent" );
+	return result;
+}
+
+void alDeferUpdatesSOFT()
+{
+	throwIfNotLoaded();
+	if( !g_alDeferUpdatesSOFT )
+	{
+		throw OpenAL::Failure( "alDeferUpdatesSOFT() not supported" );
+	}
+	takeEarlierALError();
+	if( g_directContextSupported )
+	{
+		g_alDeferUpdatesDirectSOFT( g_context );
+	}
+	else
+	{
+		g_alDeferUpdatesSOFT();
+	}
+	testForALErrorAlways( "alDeferUpdatesSOFT" );
+}
+
+void alProcessUpdatesSOFT()
+{
+	throwIfNotLoaded();
+	if( !g_alProcessUpdatesSOFT )
+	{
+		throw OpenAL::Failure( "alProcessUpdatesSOFT() not supported" );
+	}
+	takeEarlierALError();
+	if( g_directContextSupported )
+	{
+		g_alProcessUpdatesDirectSOFT( g_context );
+	}
+	else
+	{
+		g_alProcessUpdatesSOFT();
+	}
+	testForALErrorAlways( "alProcessUpdatesSOFT" );
+}
+
 ALCdevice *alcOpenDevice( const ALCchar *devicename )
 {
 	throwIfNotLoaded();
@@ -360,7 +799,13 @@ ALCcontext *alcCreateContext( ALCdevice *device, const ALCint *attrlist )
 void alcDestroyContext( ALCcontext *context )
 {
 	throwIfNotLoaded();
+	if( g_context == context )
+	{
+		g_context = NULL;
+	}
 	g_alcDestroyContext( context );
+	// contexts cached per thread may now refer to a destroyed context
+	g_contextGeneration.fetchAndAddOrdered( 1 );
 }
 
 ALCcontext *alcGetCurrentContext()
@@ -375,6 +820,18 @@ ALCboolean alcSetThreadContext( ALCcontext *context )
 	return g_alcSetThreadContext( context );
 }
 
+void alcSuspendContext( ALCcontext *context )
+{
+	throwIfNotLoaded();
+	g_alcSuspendContext( context );
+}
+
+void alcProcessContext( ALCcontext *context )
+{
+	throwIfNotLoaded();
+	g_alcProcessContext( context );
+}
+
 void alcGetIntegerv( ALCdevice *device, ALCenum param, ALCsizei size, ALCint *values )
 {
 	throwIfNotLoaded();
@@ -29,7 +29,12 @@
  * the library hasn't been loaded yet.
  * In case the actual function call fails (alGetError() or alcGetError() return
  * an error after call) the proxy functions convert the fail into an exception
- * which is thrown back to caller.
+ * which is thrown back to caller. How often alGetError() is called depends on
+ * error check mode, see ErrorCheckMode.
+ *
+ * The al-prefixed functions operate on context given with setContext(). If
+ * the library supports ALC_EXT_direct_context the context is passed to the
+ * library with each call, otherwise it is made current to calling thread.
  *
  * For rest of the documentation of al- and alc- prefixed function, see
  * OpenAL's reference documentation.
@@ -45,18 +50,67 @@
 #define ALC_HRTF_SOFT 0x1992
 #endif
 
+// default error check mode, may be overridden from build options
+#ifndef OPENAL_ERROR_CHECK_MODE
+#ifdef QT_NO_DEBUG
+#define OPENAL_ERROR_CHECK_MODE OpenAL::Proxies::CheckPerBatch
+#else
+#define OPENAL_ERROR_CHECK_MODE OpenAL::Proxies::CheckPerCall
+#endif
+#endif
+
 namespace OpenAL
 {
 
 namespace Proxies
 {
 
+/**
+ * Modes for checking errors of al-prefixed functions.
+ *
+ * Functions which create objects or return data (e.g. alGenSources() and
+ * alSourceUnqueueBuffers()) are checked on every call unless checking is
+ * off, errors left by earlier unchecked calls are not blamed on them. Names
+ * they return are validated in every mode, and all alc-prefixed functions
+ * are always checked.
+ */
+enum ErrorCheckMode
+{
+	// every call is checked, failing call throws, useful for debugging
+	CheckPerCall,
+	// errors are checked only with checkErrors() at end of a batch of calls
+	CheckPerBatch,
+	// alGetError() is never called, only returned names are validated
+	CheckOff
+};
+
+ErrorCheckMode getDefaultErrorCheckMode();
+void setErrorCheckMode( ErrorCheckMode mode );
+ErrorCheckMode getErrorCheckMode();
+
+/**
+ * Throws a failure exception which names given batch of calls if any of the
+ * calls since previous check failed. Does nothing unless in CheckPerBatch
+ * mode.
+ */
+void checkErrors( const char *batchName );
+
 void loadLib();
 void unloadLib();
 
+/**
+ * Sets context which following al-prefixed calls operate on. Thread context
+ * is switched only if direct context calls are not supported and the context
+ * isn't already current to calling thread.
+ */
+void setContext( ALCcontext *context );
+ALCcontext *getContext();
+bool isDirectContextSupported();
+
 const ALchar* alGetString( ALenum param );
 ALenum alGetError();
 void alListenerf( ALenum param, ALfloat value );
+void alDopplerFactor( ALfloat value );
 void alListener3f( ALenum param, ALfloat value1, ALfloat value2, ALfloat value3 );
 void alListenerfv( ALenum param, const ALfloat *values );
 void alGenSources( ALsizei n, ALuint *sources );
@@ -72,6 +126,9 @@ void alSourceUnqueueBuffers( ALuint source, ALsizei nb, ALuint *buffers );
 void alSourceQueueBuffers( ALuint source, ALsizei nb, const ALuint *buffers );
 void alSourcePlay( ALuint source );
 void alSourceStop( ALuint source );
+ALboolean alIsExtensionPresent( const ALchar *extname );
+void alDeferUpdatesSOFT();
+void alProcessUpdatesSOFT();
 
 ALCdevice* alcOpenDevice( const ALCchar *devicename );
 ALCboolean alcCloseDevice( ALCdevice *device );
@@ -79,6 +136,8 @@ ALCcontext* alcCreateContext( ALCdevice *device, const ALCint* attrlist );
 void alcDestroyContext( ALCcontext *context );
 ALCcontext *alcGetCurrentContext();
 ALCboolean alcSetThreadContext( ALCcontext *context );
+void alcSuspendContext( ALCcontext *context );
+void alcProcessContext( ALCcontext *context );
 void alcGetIntegerv( ALCdevice *device, ALCenum param, ALCsizei size, ALCint *values );
 ALCenum alcGetError( ALCdevice *device );
 const ALCchar* alcGetString( ALCdevice *device, ALCenum param );
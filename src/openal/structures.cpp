@@ -20,15 +20,37 @@
 
 #include "structures.h"
 
+#include <QStringList>
+#include <QMutex>
+
+namespace
+{
+QMutex gDeviceNamesMutex;
+QStringList gDeviceNames;
+
+int internDeviceName( const QString &name )
+{
+	QMutexLocker locker( &gDeviceNamesMutex );
+	int id = gDeviceNames.indexOf( name );
+	if( id == -1 )
+	{
+		gDeviceNames.append( name );
+		id = gDeviceNames.size() - 1;
+	}
+	return id;
+}
+}
+
 namespace OpenAL {
 
 OutputInfo::OutputInfo()
-	: valid( false )
+	: valid( false ), deviceId( -1 ), sampleRate( 0 ), hrtfEnabled( false )
 {
 }
 
 OutputInfo::OutputInfo( const QString &deviceName, quint32 sampleRate, bool hrtfEnabled )
-	: valid( true ), deviceName( deviceName ), sampleRate( sampleRate ), hrtfEnabled( hrtfEnabled )
+	: valid( true ), deviceName( deviceName ), deviceId( internDeviceName( deviceName ) ),
+	  sampleRate( sampleRate ), hrtfEnabled( hrtfEnabled )
 {
 }
 
@@ -54,14 +76,20 @@ bool OutputInfo::isHrtfEnabled() const
 
 bool OutputInfo::operator<( const OutputInfo &other ) const
 {
-	return deviceName < other.deviceName &&
-			sampleRate < other.sampleRate &&
-			hrtfEnabled < other.hrtfEnabled;
+	if( deviceId != other.deviceId )
+	{
+		return deviceId < other.deviceId;
+	}
+	if( sampleRate != other.sampleRate )
+	{
+		return sampleRate < other.sampleRate;
+	}
+	return hrtfEnabled < other.hrtfEnabled;
 }
 
 bool OutputInfo::operator==( const OutputInfo &other ) const
 {
-	return deviceName == other.deviceName &&
+	return deviceId == other.deviceId &&
 			sampleRate == other.sampleRate &&
 			hrtfEnabled == other.hrtfEnabled;
 }
@@ -82,10 +110,11 @@ SourceInfo::SourceInfo( const OutputInfo &outputInfo,
 						const Entity::Vector &position,
 						qreal rolloffFactor,
 						bool relative,
-						bool streaming )
+						bool streaming,
+						bool directChannels )
 	: valid( true ), outputInfo( outputInfo ), id( id ), position( position ),
 	  rolloffFactor( rolloffFactor ), relative( relative ),
-	  streaming( streaming )
+	  streaming( streaming ), directChannels( directChannels )
 {
 }
 
@@ -124,6 +153,11 @@ bool SourceInfo::isStreaming() const
 	return streaming;
 }
 
+bool SourceInfo::isDirectChannels() const
+{
+	return directChannels;
+}
+
 ListenerInfo::ListenerInfo()
 	: valid( false ), gain( 0 )
 {
@@ -211,4 +245,9 @@ const void *AudioData::getData() const
 	return data;
 }
 
+Statistics::Statistics()
+	: buffersCreated( 0 ), buffersRecycled( 0 ), underruns( 0 )
+{
+}
+
 }
@@ -36,6 +36,12 @@ namespace OpenAL {
 class OutputInfo
 {
 public:
+	/**
+	 * Output sampling rate to use unless there is a reason to use something
+	 * else. Same rate as TeamSpeak's audio, so voice needs no resampling.
+	 */
+	static const quint32 DEFAULT_SAMPLE_RATE = 48000;
+
 	/**
 	 * Default constructor.
 	 * Builds an invalid OutputDevice object.
@@ -46,8 +52,12 @@ public:
 	 * Parametrized constructor.
 	 * Builds a valid OutputDevice object.
 	 *
+	 * The device name is interned to an integer id so that comparing
+	 * OutputInfo objects doesn't need to compare strings. Construct the
+	 * object once and reuse it rather than building it for every call.
+	 *
 	 * @param deviceName  name of device (as provided by TeamSpeak)
-	 * @param sampleRate  context's output sampling rate (e.g. 44100)
+	 * @param sampleRate  context's output sampling rate (e.g. DEFAULT_SAMPLE_RATE)
 	 * @param hrtfEnabled true if HRTF should be enabled, false if not
 	 */
 	OutputInfo( const QString &deviceName, quint32 sampleRate, bool hrtfEnabled );
@@ -102,6 +112,7 @@ public:
 private:
 	bool valid;
 	QString deviceName;
+	int deviceId;
 	quint32 sampleRate;
 	bool hrtfEnabled;
 };
@@ -115,7 +126,9 @@ private:
  * ID-parameter is what indentifies the audio source. The ID-value is tied to
  * the underlying OpenAL source object and any other parameters in SourceInfo
  * are applied to that source object. Any changed parameters in SourceInfo are
- * applied to a existing source object if one exists.
+ * applied to a existing source object if one exists. The ID-value is also
+ * used as index to a flat table of sources, so the IDs should be small and
+ * dense.
  *
  * In case the source doesn't exist then a new source object is created and
  * tied to the provided SourceInfo ID-value. The source object will exist as
@@ -143,8 +156,10 @@ public:
 	 * @param rolloffFactor factor for adjusting effect of distance to sound volume
 	 * @param relative      true if the source is relative to listener
 	 * @param streaming     true if audio data is streamed to source
+	 * @param directChannels true if multichannel audio goes to output
+	 *                       channels as is, bypassing virtualization and HRTF
 	 */
-	SourceInfo( const OutputInfo &outputInfo, quint32 id, const Entity::Vector &position, qreal rolloffFactor, bool relative, bool streaming );
+	SourceInfo( const OutputInfo &outputInfo, quint32 id, const Entity::Vector &position, qreal rolloffFactor, bool relative, bool streaming, bool directChannels = false );
 
 	/**
 	 * Returns true if object is valid or false if invalid.
@@ -189,6 +204,14 @@ public:
 	 */
 	bool isStreaming() const;
 
+	/**
+	 * Returns true if multichannel audio of the source is played directly
+	 * to matching output channels without HRTF or virtual speakers.
+	 *
+	 * Requires AL_SOFT_direct_channels, mono audio is positioned as usual.
+	 */
+	bool isDirectChannels() const;
+
 private:
 	bool valid;
 	OutputInfo outputInfo;
@@ -197,6 +220,7 @@ private:
 	qreal rolloffFactor;
 	bool relative;
 	bool streaming;
+	bool directChannels;
 };
 
 /**
@@ -288,7 +312,7 @@ public:
 	 * Builds a valid ListenerInfo object.
 	 *
 	 * @param channelCount number of channels (1 = mono, 2 = stereo, etc...)
-	 * @param sampleSize   size of sample in bits (8 or 16)
+	 * @param sampleSize   size of sample in bits (8 or 16, or 32 for float)
 	 * @param dataSize     size of the audio data in bytes
 	 * @param sampleRate   sampling rate of the data (e.g. 44100)
 	 * @param data         pointer to the audio data
@@ -328,6 +352,38 @@ private:
 	const void *data;
 };
 
+/**
+ * The Statistics class contains counters collected from OpenAL usage.
+ *
+ * The counters are cumulative since the OpenAL library was last loaded.
+ */
+class Statistics
+{
+public:
+	/**
+	 * Default constructor.
+	 * Builds a Statistics object with all counters set to zero.
+	 */
+	Statistics();
+
+	/**
+	 * Count of OpenAL buffers generated for streaming sources.
+	 */
+	quint64 buffersCreated;
+
+	/**
+	 * Count of streamed audio data chunks which were filled into a recycled
+	 * buffer from source's buffer pool, instead of generating a new buffer.
+	 */
+	quint64 buffersRecycled;
+
+	/**
+	 * Count of times a streaming source ran out of audio data in middle of
+	 * a talk burst.
+	 */
+	quint64 underruns;
+};
+
 /**
  * The Failure exception class is thrown from OpenAL calls to indicate an error.
  */
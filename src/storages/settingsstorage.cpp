@@ -37,8 +37,14 @@ Entity::Settings SettingsStorage::get() const
 	settings.positioningEnabled = driver->get( "General", "PositionalAudioEnabled", true ).toBool();
 	settings.testRotateMode     = (Entity::RotateMode) driver->get( "General", "TestRotateMode", Entity::RotateYAxis ).toInt();
 	settings.hrtfEnabled        = driver->get( "General", "HrtfEnabled", false ).toBool();
-	settings.hrtfDataSet        = driver->get( "General", "HrtfDataSet", ":/etc/hrtfs/mit_kemar-44100.mhr" ).toString();
+	// default was mit_kemar-44100.mhr until the output moved to 48 kHz, users
+	// who never saved a data set get default-48000.mhr and hear a different HRTF
+	settings.hrtfDataSet        = driver->get( "General", "HrtfDataSet", "default-48000.mhr" ).toString();
+	settings.hrtfVoiceLimit     = driver->get( "General", "HrtfVoiceLimit", 8 ).toInt();
 	settings.audioLoggingLevel  = driver->get( "General", "AudioLoggingLevel", 0 ).toInt();
+	settings.poseUpdateRate     = driver->get( "General", "PoseUpdateRate", 60 ).toInt();
+	settings.positionAngleThreshold    = driver->get( "General", "PositionAngleThreshold", 1.0 ).toDouble();
+	settings.positionDistanceThreshold = driver->get( "General", "PositionDistanceThreshold", 2.0 ).toDouble();
 	return settings;
 }
 
@@ -49,7 +55,11 @@ void SettingsStorage::set( const Entity::Settings &settings )
 	driver->set( "General", "TestRotateMode",         (int)settings.testRotateMode );
 	driver->set( "General", "HrtfEnabled",            settings.hrtfEnabled );
 	driver->set( "General", "HrtfDataSet",            settings.hrtfDataSet );
+	driver->set( "General", "HrtfVoiceLimit",         settings.hrtfVoiceLimit );
 	driver->set( "General", "AudioLoggingLevel",      settings.audioLoggingLevel );
+	driver->set( "General", "PoseUpdateRate",         settings.poseUpdateRate );
+	driver->set( "General", "PositionAngleThreshold",    settings.positionAngleThreshold );
+	driver->set( "General", "PositionDistanceThreshold", settings.positionDistanceThreshold );
 }
 
 }
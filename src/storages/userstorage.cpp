@@ -19,42 +19,162 @@
  */
 
 #include "userstorage.h"
+#include "../entities/gamestate.h"
+
+namespace
+{
+const int CLIENT_ID_COUNT = 0x10000;
+const int BITS_PER_WORD = 32;
+}
 
 namespace Storage
 {
 
 UserStorage::UserStorage( QObject *parent )
-	: QObject( parent )
+	: QObject( parent ), indexById( CLIENT_ID_COUNT, -1 )
 {
 }
 
 bool UserStorage::has( quint16 id ) const
 {
-	return users.contains( id );
+	return indexById[id] != -1;
 }
 
 Entity::User UserStorage::get( quint16 id ) const
 {
-	if( has( id ) )
+	const int index = indexById[id];
+	if( index != -1 )
 	{
-		return users[id];
+		return getAt( index );
 	}
-	throw new std::runtime_error( "User not found from storage" );
+	Entity::User user;
+	user.id = id;
+	return user;
 }
 
 QList<Entity::User> UserStorage::getAll() const
 {
-	return users.values();
+	QList<Entity::User> users;
+	for( int index = 0; index < ids.size(); index++ )
+	{
+		users.append( getAt( index ) );
+	}
+	return users;
 }
 
 void UserStorage::set( const Entity::User &user )
 {
-	users[user.id] = user;
+	int index = indexById[user.id];
+	if( index == -1 )
+	{
+		index = ids.size();
+		indexById[user.id] = index;
+		ids.append( user.id );
+		positions.append( user.position );
+		flags.append( 0 );
+		if( index % BITS_PER_WORD == 0 )
+		{
+			dirtyWords.append( 0 );
+		}
+	}
+	positions[index] = user.position;
+	flags[index] = ( user.inGame? InGame: 0 ) | ( user.inChat? InChat: 0 );
+	setDirty( index, true );
 }
 
 void UserStorage::remove( quint16 id )
 {
-	users.remove( id );
+	const int index = indexById[id];
+	if( index == -1 )
+	{
+		return;
+	}
+	const int last = ids.size() - 1;
+	if( index != last )
+	{
+		ids[index] = ids[last];
+		positions[index] = positions[last];
+		flags[index] = flags[last];
+		setDirty( index, isDirty( last ) );
+		indexById[ids[index]] = index;
+	}
+	setDirty( last, false );
+	ids.removeLast();
+	positions.removeLast();
+	flags.removeLast();
+	if( last % BITS_PER_WORD == 0 )
+	{
+		dirtyWords.removeLast();
+	}
+	indexById[id] = -1;
+}
+
+void UserStorage::updatePositions( const Entity::UserPosition *updates, int count )
+{
+	for( int i = 0; i < count; i++ )
+	{
+		const int index = indexById[updates[i].id];
+		if( index != -1 && positions[index] != updates[i].position )
+		{
+			positions[index] = updates[i].position;
+			setDirty( index, true );
+		}
+	}
+}
+
+void UserStorage::visitPaired( const Visitor &visitor ) const
+{
+	for( int index = 0; index < ids.size(); index++ )
+	{
+		if( ( flags[index] & Paired ) == Paired )
+		{
+			visitor( getAt( index ) );
+		}
+	}
+}
+
+void UserStorage::visitDirty( const Visitor &visitor )
+{
+	for( int word = 0; word < dirtyWords.size(); word++ )
+	{
+		quint32 bits = dirtyWords[word];
+		dirtyWords[word] = 0;
+		for( int index = word * BITS_PER_WORD; bits != 0; index++, bits >>= 1 )
+		{
+			if( bits & 1 )
+			{
+				visitor( getAt( index ) );
+			}
+		}
+	}
+}
+
+Entity::User UserStorage::getAt( int index ) const
+{
+	Entity::User user;
+	user.id = ids[index];
+	user.position = positions[index];
+	user.inGame = flags[index] & InGame;
+	user.inChat = flags[index] & InChat;
+	return user;
+}
+
+void UserStorage::setDirty( int index, bool dirty )
+{
+	const quint32 mask = 1u << ( index % BITS_PER_WORD );
+	if( dirty )
+	{
+		dirtyWords[index / BITS_PER_WORD] |= mask;
+	}
+	else
+	{
+		dirtyWords[index / BITS_PER_WORD] &= ~mask;
+	}
+}
+
+bool UserStorage::isDirty( int index ) const
+{
+	return dirtyWords[index / BITS_PER_WORD] & ( 1u << ( index % BITS_PER_WORD ) );
 }
 
 }
@@ -22,12 +22,21 @@
 
 #include "../interfaces/storages.h"
 #include "../entities/user.h"
-#include <QMap>
+#include <QVector>
 #include <QObject>
 
 namespace Storage
 {
 
+/**
+ * The UserStorage class stores users in arrays indexed through a table of
+ * all client ids, with positions and flags in separate arrays so that a pass
+ * over them touches only what it needs.
+ *
+ * Users whose position or flags are set are marked dirty until visited with
+ * visitDirty(). get() of a user not in the storage returns a user with
+ * given id and no flags.
+ */
 class UserStorage : public QObject, public Interfaces::UserStorage
 {
 	Q_OBJECT
@@ -40,9 +49,32 @@ public:
 	QList<Entity::User> getAll() const;
 	void set( const Entity::User &user );
 	void remove( quint16 id );
+	void updatePositions( const Entity::UserPosition *positions, int count );
+	void visitPaired( const Visitor &visitor ) const;
+	void visitDirty( const Visitor &visitor );
+
+private:
+	enum Flag
+	{
+		InGame = 1,
+		InChat = 2,
+		Paired = InGame | InChat
+	};
+
+	Entity::User getAt( int index ) const;
+	void setDirty( int index, bool dirty );
+	bool isDirty( int index ) const;
 
 private:
-	QMap<quint16, Entity::User> users;
+	// index to arrays below for each client id, -1 if not stored
+	QVector<qint32> indexById;
+	// users packed to start of the arrays, removing a user moves the last
+	// user to its place
+	QVector<quint16> ids;
+	QVector<Entity::Vector> positions;
+	QVector<quint8> flags;
+	// bit per user, 32 users per word
+	QVector<quint32> dirtyWords;
 };
 
 }
@@ -149,6 +149,18 @@ void SettingsDialog::setHrtfDataSet( const QString &name )
 	enableApplyButton( areSettingsUnapplied() );
 }
 
+int SettingsDialog::getHrtfVoiceLimit() const
+{
+	return ui->hrtfVoiceLimitSpinBox->value();
+}
+
+void SettingsDialog::setHrtfVoiceLimit( int limit )
+{
+	ui->hrtfVoiceLimitSpinBox->setValue( limit );
+	hrtfVoiceLimit = limit;
+	enableApplyButton( areSettingsUnapplied() );
+}
+
 int SettingsDialog::getLoggingLevel() const
 {
 	return ui->loggingLevelComboBox->currentIndex();
@@ -250,6 +262,7 @@ bool SettingsDialog::areSettingsUnapplied() const
 		getAudioBackend() == audioBackend &&
 		isHrtfEnabled() == hrtfEnabled &&
 		getHrtfDataSet() == hrtfDataSet &&
+		getHrtfVoiceLimit() == hrtfVoiceLimit &&
 		getLoggingLevel() == loggingLevel
 	);
 }
@@ -269,6 +282,7 @@ void SettingsDialog::on_buttonBox_clicked( QAbstractButton *button )
 		audioBackend = getAudioBackend();
 		hrtfEnabled = isHrtfEnabled();
 		hrtfDataSet = getHrtfDataSet();
+		hrtfVoiceLimit = getHrtfVoiceLimit();
 		loggingLevel = getLoggingLevel();
 		enableApplyButton( areSettingsUnapplied() );
 	}
@@ -284,6 +298,12 @@ void SettingsDialog::on_loggingLevelComboBox_currentIndexChanged( int index )
 	enableApplyButton( areSettingsUnapplied() );
 }
 
+void SettingsDialog::on_hrtfVoiceLimitSpinBox_valueChanged( int value )
+{
+	Q_UNUSED( value );
+	enableApplyButton( areSettingsUnapplied() );
+}
+
 void SettingsDialog::on_openALAdvancedButton_clicked()
 {
 	QDesktopServices::openUrl( QUrl::fromLocalFile( openALConfFilePath ) );
@@ -53,6 +53,9 @@ public:
 	QString getHrtfDataSet() const;
 	void setHrtfDataSet( const QString &name );
 
+	int getHrtfVoiceLimit() const;
+	void setHrtfVoiceLimit( int limit );
+
 	int getLoggingLevel() const;
 	void setLoggingLevel( int level );
 
@@ -71,6 +74,7 @@ private slots:
 	void on_positionalAudioCheckBox_toggled();
 	void on_buttonBox_clicked( QAbstractButton *button );
 	void on_loggingLevelComboBox_currentIndexChanged( int index );
+	void on_hrtfVoiceLimitSpinBox_valueChanged( int value );
 	void on_openALAdvancedButton_clicked();
 	void onHrtfSelectionChanged();
 
@@ -89,6 +93,7 @@ private:
 	int audioBackend;
 	bool positionalAudioEnabled;
 	bool hrtfEnabled;
+	int hrtfVoiceLimit;
 	int loggingLevel;
 	QString hrtfDataSet;
 	QString openALConfFilePath;
@@ -0,0 +1,174 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+#include "changefilter.h"
+#include "../entities/user.h"
+#include <QString>
+#include <QtMath>
+#include <limits>
+
+namespace
+{
+
+QString formatCount( const QString &name, quint64 forwarded, quint64 suppressed )
+{
+	const quint64 total = forwarded + suppressed;
+	const qreal percent = total > 0? 100.0 * suppressed / total: 0.0;
+	return QString( "%1 updates: %2 forwarded, %3 suppressed (%4%)" )
+		.arg( name )
+		.arg( forwarded )
+		.arg( suppressed )
+		.arg( percent, 0, 'f', 1 );
+}
+
+}
+
+namespace UseCase
+{
+
+ChangeFilter::ChangeFilter()
+	: angleCosine( 1 ), distanceRatio( 0 ), forwardedUsers( 0 ), suppressedUsers( 0 ),
+	  forwardedCameras( 0 ), suppressedCameras( 0 )
+{
+}
+
+void ChangeFilter::setThresholds( qreal angleThreshold, qreal distanceThreshold )
+{
+	angleCosine = qCos( qDegreesToRadians( qMax<qreal>( angleThreshold, 0 ) ) );
+	distanceRatio = qMax<qreal>( distanceThreshold, 0 ) / 100.0;
+}
+
+bool ChangeFilter::filterCamera( const Entity::Camera &camera )
+{
+	if( isCameraChangeSignificant( camera ) )
+	{
+		appliedCamera = camera;
+		forwardedCameras++;
+		return true;
+	}
+	suppressedCameras++;
+	return false;
+}
+
+bool ChangeFilter::filterUser( const Entity::User &user )
+{
+	QHash<quint16, Entity::Vector>::iterator applied = appliedPositions.find( user.id );
+	if( !user.hasPosition() || applied == appliedPositions.end() || isUserChangeSignificant( *applied, user.position ) )
+	{
+		setUserApplied( user );
+		forwardedUsers++;
+		return true;
+	}
+	suppressedUsers++;
+	return false;
+}
+
+void ChangeFilter::setUserApplied( const Entity::User &user )
+{
+	if( user.hasPosition() )
+	{
+		appliedPositions[user.id] = user.position;
+	}
+	else
+	{
+		appliedPositions.remove( user.id );
+	}
+}
+
+void ChangeFilter::removeUser( quint16 id )
+{
+	appliedPositions.remove( id );
+}
+
+bool ChangeFilter::isEnabled() const
+{
+	return angleCosine < 1 || distanceRatio > 0;
+}
+
+QStringList ChangeFilter::getStatistics() const
+{
+	QStringList lines;
+	lines << formatCount( "User position", forwardedUsers, suppressedUsers );
+	lines << formatCount( "Camera", forwardedCameras, suppressedCameras );
+	return lines;
+}
+
+bool ChangeFilter::isUserChangeSignificant( const Entity::Vector &applied, const Entity::Vector &position ) const
+{
+	if( !isEnabled() )
+	{
+		return true;
+	}
+	const Entity::Vector appliedRelative = applied - appliedCamera.position;
+	const Entity::Vector relative = position - appliedCamera.position;
+	const qreal appliedDistance = appliedRelative.getLength();
+	const qreal distance = relative.getLength();
+	if( appliedDistance <= 0 || distance <= 0 )
+	{
+		return applied != position;
+	}
+	if( qAbs( distance - appliedDistance ) > appliedDistance * distanceRatio )
+	{
+		return true;
+	}
+	// compare cosines to avoid acos(), rounding may put cosine of equal
+	// directions slightly above one
+	return appliedRelative.dotProduct( relative ) / ( appliedDistance * distance ) < angleCosine;
+}
+
+bool ChangeFilter::isCameraChangeSignificant( const Entity::Camera &camera ) const
+{
+	if( !isEnabled() || !appliedCamera.isSet() )
+	{
+		return true;
+	}
+	const qreal appliedLength = appliedCamera.direction.getLength();
+	const qreal length = camera.direction.getLength();
+	if( appliedLength <= 0 || length <= 0 )
+	{
+		if( camera.direction != appliedCamera.direction )
+		{
+			return true;
+		}
+	}
+	else if( appliedCamera.direction.dotProduct( camera.direction ) / ( appliedLength * length ) < angleCosine )
+	{
+		return true;
+	}
+	// moving the listener by distance d turns and scales direction to a
+	// user at distance r by at most d / r, so the nearest user decides
+	const qreal movement = ( camera.position - appliedCamera.position ).getLength();
+	if( movement <= 0 )
+	{
+		return false;
+	}
+	if( appliedPositions.isEmpty() )
+	{
+		return true;
+	}
+	qreal nearestDistance = std::numeric_limits<qreal>::max();
+	foreach( const Entity::Vector &position, appliedPositions )
+	{
+		nearestDistance = qMin( nearestDistance, ( position - appliedCamera.position ).getLength() );
+	}
+	const qreal angleRatio = qSqrt( qMax<qreal>( 1 - angleCosine * angleCosine, 0 ) );
+	return movement > nearestDistance * qMin( angleRatio, distanceRatio );
+}
+
+}
@@ -0,0 +1,91 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+#pragma once
+
+#include "../entities/vector.h"
+#include "../entities/camera.h"
+#include <QHash>
+#include <QStringList>
+
+namespace Entity
+{
+class User;
+}
+
+namespace UseCase
+{
+
+/**
+ * Filters out pose updates which the listener would not hear.
+ *
+ * Remembers poses last given to audio backends and compares new poses to
+ * them relative to the listener: a user update is significant if direction
+ * from the listener turns more than the angle threshold or distance from
+ * the listener changes more than the distance threshold. Camera updates
+ * are compared against the nearest user in the same manner.
+ */
+class ChangeFilter
+{
+public:
+	ChangeFilter();
+
+	/**
+	 * Sets angle threshold in degrees and distance threshold in percents,
+	 * zero thresholds let all changes through.
+	 */
+	void setThresholds( qreal angleThreshold, qreal distanceThreshold );
+
+	/**
+	 * Returns true if camera should be given to audio backends and stores
+	 * it as applied, false if the update should be dropped.
+	 */
+	bool filterCamera( const Entity::Camera &camera );
+
+	/**
+	 * Returns true if user's position should be given to audio backends
+	 * and stores it as applied, false if the update should be dropped.
+	 */
+	bool filterUser( const Entity::User &user );
+
+	/**
+	 * Stores user's position as applied without filtering.
+	 */
+	void setUserApplied( const Entity::User &user );
+	void removeUser( quint16 id );
+
+	QStringList getStatistics() const;
+
+private:
+	bool isEnabled() const;
+	bool isUserChangeSignificant( const Entity::Vector &applied, const Entity::Vector &position ) const;
+	bool isCameraChangeSignificant( const Entity::Camera &camera ) const;
+
+private:
+	qreal angleCosine;
+	qreal distanceRatio;
+	Entity::Camera appliedCamera;
+	QHash<quint16, Entity::Vector> appliedPositions;
+	quint64 forwardedUsers;
+	quint64 suppressedUsers;
+	quint64 forwardedCameras;
+	quint64 suppressedCameras;
+};
+
+}
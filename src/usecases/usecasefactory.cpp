@@ -25,83 +25,79 @@ namespace UseCase
 {
 
 UseCaseFactory::UseCaseFactory( QObject *parent )
-	: QObject( parent )
+	: QObject( parent ), useCases( NULL )
 {
 }
 
 void UseCaseFactory::applicationInitialize()
 {
-	createUseCases()->applicationInitialize();
+	getUseCases()->applicationInitialize();
 }
 
-void UseCaseFactory::positionUser( quint16 id, const Entity::Vector& position )
+void UseCaseFactory::updateGameState( const Entity::GameState &state )
 {
-	createUseCases()->positionUser( id, position );
-}
-
-void UseCaseFactory::positionCamera( const Entity::Vector& position, const Entity::Vector& direction )
-{
-	createUseCases()->positionCamera( position, direction );
-}
-
-void UseCaseFactory::addGameUser( quint16 id )
-{
-	createUseCases()->addGameUser( id );
-}
-
-void UseCaseFactory::removeGameUser( quint16 id )
-{
-	createUseCases()->removeGameUser( id );
+	getUseCases()->updateGameState( state );
 }
 
 void UseCaseFactory::addChatUser( quint16 id )
 {
-	createUseCases()->addChatUser( id );
+	getUseCases()->addChatUser( id );
 }
 
 void UseCaseFactory::removeChatUser( quint16 id )
 {
-	createUseCases()->removeChatUser( id );
+	getUseCases()->removeChatUser( id );
 }
 
 void UseCaseFactory::changePlaybackDevice()
 {
-	createUseCases()->changePlaybackDevice();
+	getUseCases()->changePlaybackDevice();
 }
 
 void UseCaseFactory::changePlaybackVolume()
 {
-	createUseCases()->changePlaybackVolume();
+	getUseCases()->changePlaybackVolume();
 }
 
 void UseCaseFactory::showSettingsUi( QWidget *parent )
 {
-	createUseCases()->showSettingsUi( parent );
+	getUseCases()->showSettingsUi( parent );
 }
 
 void UseCaseFactory::saveSettings( const Entity::Settings &settings )
 {
-	createUseCases()->saveSettings( settings );
+	getUseCases()->saveSettings( settings );
 }
 
 void UseCaseFactory::playTestAudioWithSettings(const Entity::Settings &settings, Callback result )
 {
-	createUseCases()->playTestAudioWithSettings( settings, result );
+	getUseCases()->playTestAudioWithSettings( settings, result );
 }
 
 void UseCaseFactory::showPluginHelp()
 {
-	createUseCases()->showPluginHelp();
+	getUseCases()->showPluginHelp();
+}
+
+void UseCaseFactory::showStatistics( QWidget *parent )
+{
+	getUseCases()->showStatistics( parent );
 }
 
-UseCases *UseCaseFactory::createUseCases() const
+UseCases *UseCaseFactory::getUseCases()
 {
-	UseCases* cases = new UseCases();
-	cases->adapterStorage = adapterStorage;
-	cases->cameraStorage = cameraStorage;
-	cases->userStorage = userStorage;
-	cases->settingsStorage = settingsStorage;
-	return cases;
+	// one instance serves all calls and must persist between them, as the
+	// use cases own the change filter which tracks applied poses, created on
+	// first call as storages are set after construction
+	if( !useCases )
+	{
+		useCases = new UseCases( this );
+		useCases->adapterStorage = adapterStorage;
+		useCases->cameraStorage = cameraStorage;
+		useCases->userStorage = userStorage;
+		useCases->settingsStorage = settingsStorage;
+	}
+	return useCases;
 }
 
 }
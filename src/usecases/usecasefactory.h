@@ -38,10 +38,7 @@ public:
 	UseCaseFactory( QObject *parent );
 
 	void applicationInitialize();
-	void positionUser( quint16 id, const Entity::Vector& position );
-	void positionCamera( const Entity::Vector& position, const Entity::Vector& direction );
-	void addGameUser( quint16 id );
-	void removeGameUser( quint16 id );
+	void updateGameState( const Entity::GameState &state );
 	void addChatUser( quint16 id );
 	void removeChatUser( quint16 id );
 	void changePlaybackDevice();
@@ -50,15 +47,20 @@ public:
 	void saveSettings( const Entity::Settings &settings );
 	void playTestAudioWithSettings( const Entity::Settings &settings, Callback result );
 	void showPluginHelp();
+	void showStatistics( QWidget *parent );
 
 private:
-	UseCases* createUseCases() const;
+	UseCases* getUseCases();
 
 public:
 	Interfaces::UserStorage* userStorage;
 	Interfaces::CameraStorage* cameraStorage;
 	Interfaces::SettingsStorage* settingsStorage;
 	Interfaces::AdapterStorage* adapterStorage;
+
+private:
+	// created once and kept, holds state between calls
+	UseCases* useCases;
 };
 
 }
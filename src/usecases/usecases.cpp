@@ -21,6 +21,7 @@
 #include "usecases.h"
 #include "../entities/user.h"
 #include "../entities/camera.h"
+#include "../entities/gamestate.h"
 #include "../entities/settings.h"
 #include "../entities/failures.h"
 #include "../utils/logging.h"
@@ -34,6 +35,11 @@
 namespace UseCase
 {
 
+UseCases::UseCases( QObject *parent )
+	: QObject( parent ), userStorage( NULL ), cameraStorage( NULL ), settingsStorage( NULL ), adapterStorage( NULL )
+{
+}
+
 void UseCases::applicationInitialize()
 {
 	Entity::Settings settings = settingsStorage->get();
@@ -46,74 +52,101 @@ void UseCases::applicationInitialize()
 		{
 			backend->setHrtfEnabled( settings.hrtfEnabled );
 			backend->setHrtfDataSet( settings.hrtfDataSet );
+			backend->setHrtfVoiceLimit( settings.hrtfVoiceLimit );
 			backend->setLoggingLevel( settings.audioLoggingLevel );
 		}
 
 		adapterStorage->getAudio( settings.audioBackend )->setEnabled( true );
 	}
-	deleteLater();
+	adapterStorage->getGameData()->setPoseUpdateRate( settings.poseUpdateRate );
+	changeFilter.setThresholds( settings.positionAngleThreshold, settings.positionDistanceThreshold );
 }
 
-void UseCases::positionUser( quint16 id, const Entity::Vector& position )
+void UseCases::updateGameState( const Entity::GameState &state )
 {
-	if( userStorage->has( id ) )
+	const QList<Interfaces::AudioAdapter*> backends = adapterStorage->getAudios();
+
+	foreach( quint16 id, state.removedUsers )
 	{
+		if( !userStorage->has( id ) )
+		{
+			continue;
+		}
 		Entity::User user = userStorage->get( id );
-		user.position = position;
-		userStorage->set( user );
-		positionUserToAudioBackends( user );
+		if( user.paired() )
+		{
+			foreach( Interfaces::AudioAdapter *backend, backends )
+			{
+				backend->removeUser( user );
+			}
+			changeFilter.removeUser( id );
+		}
+		user.inGame = false;
+		if( user.exists() )
+		{
+			userStorage->set( user );
+		}
+		else
+		{
+			userStorage->remove( id );
+		}
 	}
-	deleteLater();
-}
 
-void UseCases::positionCamera( const Entity::Vector& position, const Entity::Vector& direction )
-{
-	Entity::Camera camera = cameraStorage->get();
-	camera.position = position;
-	camera.direction = direction;
-	cameraStorage->set( camera );
-	foreach( Interfaces::AudioAdapter *backend, adapterStorage->getAudios() )
+	const quint16 myUserId = adapterStorage->getVoiceChat()->getMyUserId();
+	foreach( quint16 id, state.addedUsers )
 	{
-		backend->positionCamera( camera );
+		if( id == myUserId )
+		{
+			continue;
+		}
+		Entity::User user;
+		if( userStorage->has( id ) )
+		{
+			user = userStorage->get( id );
+		}
+		else
+		{
+			user.id = id;
+		}
+		user.inGame = true;
+		userStorage->set( user );
 	}
-	deleteLater();
-}
 
-void UseCases::addGameUser( quint16 id )
-{
-	if( adapterStorage->getVoiceChat()->getMyUserId() == id )
-	{
-		return;
-	}
-	Entity::User user;
-	if( userStorage->has( id ) )
-	{
-		user = userStorage->get( id );
-	}
-	else
+	// camera goes first as user changes are filtered relative to the
+	// camera that audio backends have
+	if( state.cameraChanged )
 	{
-		user.id = id;
+		Entity::Camera camera = cameraStorage->get();
+		camera.position = state.cameraPosition;
+		camera.direction = state.cameraDirection;
+		cameraStorage->set( camera );
+		if( changeFilter.filterCamera( camera ) )
+		{
+			foreach( Interfaces::AudioAdapter *backend, backends )
+			{
+				backend->positionCamera( camera );
+			}
+		}
 	}
-	user.inGame = true;
-	userStorage->set( user );
-	positionUserToAudioBackends( user );
-	deleteLater();
-}
 
-void UseCases::removeGameUser( quint16 id )
-{
-	if( !userStorage->has( id ) )
-	{
-		return;
-	}
-	Entity::User user = userStorage->get( id );
-	removeUserFromAudioBackends( user );
-	user.inGame = false;
-	if( !user.exists() )
+	// added users are positioned along with moved users, once they have a
+	// position
+	userStorage->updatePositions( state.movedUsers.constData(), state.movedUsers.size() );
+	userStorage->visitDirty( [&]( const Entity::User &user ) {
+		if( user.paired() && changeFilter.filterUser( user ) )
+		{
+			foreach( Interfaces::AudioAdapter *backend, backends )
+			{
+				backend->positionUser( user );
+			}
+		}
+	} );
+
+	// end of game tick, backends apply all of it at once
+	foreach( Interfaces::AudioAdapter *backend, backends )
 	{
-		userStorage->remove( id );
+		backend->flush();
 	}
-	deleteLater();
 }
 
 void UseCases::addChatUser( quint16 id )
@@ -131,7 +164,6 @@ void UseCases::addChatUser( quint16 id )
 	user.inChat = true;
 	userStorage->set( user );
 	positionUserToAudioBackends( user );
-	deleteLater();
 }
 
 void UseCases::removeChatUser( quint16 id )
@@ -147,19 +179,16 @@ void UseCases::removeChatUser( quint16 id )
 	{
 		userStorage->remove( id );
 	}
-	deleteLater();
 }
 
 void UseCases::changePlaybackDevice()
 {
 	updatePlaybackDeviceToBackends();
-	deleteLater();
 }
 
 void UseCases::changePlaybackVolume()
 {
 	updatePlaybackVolumeToBackends();
-	deleteLater();
 }
 
 void UseCases::showSettingsUi( QWidget *parent )
@@ -171,13 +200,14 @@ void UseCases::showSettingsUi( QWidget *parent )
 		hrtfDataNames.append( backend->getHrtfDataFileNames() );
 	}
 	adapterStorage->getUi()->showSettingsUi( settings, hrtfDataNames, parent );
-	deleteLater();
 }
 
 void UseCases::saveSettings( const Entity::Settings &settings )
 {
 	Entity::Settings originalSettings = settingsStorage->get();
 	settingsStorage->set( settings );
+	adapterStorage->getGameData()->setPoseUpdateRate( settings.poseUpdateRate );
+	changeFilter.setThresholds( settings.positionAngleThreshold, settings.positionDistanceThreshold );
 	if( settings.positioningEnabled )
 	{
 		if( originalSettings.audioBackend != settings.audioBackend )
@@ -188,6 +218,7 @@ void UseCases::saveSettings( const Entity::Settings &settings )
 		{
 			backend->setHrtfEnabled( settings.hrtfEnabled );
 			backend->setHrtfDataSet( settings.hrtfDataSet );
+			backend->setHrtfVoiceLimit( settings.hrtfVoiceLimit );
 			backend->setLoggingLevel( settings.audioLoggingLevel );
 		}
 		adapterStorage->getAudio( settings.audioBackend )->setEnabled( true );
@@ -200,7 +231,6 @@ void UseCases::saveSettings( const Entity::Settings &settings )
 			adapterStorage->getAudio( originalSettings.audioBackend )->setEnabled( false );
 		}
 	}
-	deleteLater();
 }
 
 void UseCases::playTestAudioWithSettings(const Entity::Settings &settings, Callback callback )
@@ -208,12 +238,10 @@ void UseCases::playTestAudioWithSettings(const Entity::Settings &settings, Callb
 	Interfaces::AudioAdapter *backend = adapterStorage->getTestAudio( settings.audioBackend );
 	backend->setHrtfEnabled( settings.hrtfEnabled );
 	backend->setHrtfDataSet( settings.hrtfDataSet );
+	backend->setHrtfVoiceLimit( settings.hrtfVoiceLimit );
 	backend->setLoggingLevel( settings.audioLoggingLevel );
 	backend->setEnabled( settings.positioningEnabled );
-	backend->playTestSound( settings.testRotateMode, [=]( QVariant result ) {
-		deleteLater();
-		callback( result );
-	} );
+	backend->playTestSound( settings.testRotateMode, callback );
 }
 
 void UseCase::UseCases::showPluginHelp()
@@ -221,6 +249,11 @@ void UseCase::UseCases::showPluginHelp()
 	QDesktopServices::openUrl( QUrl( "https://github.com/jhakonen/wot-teamspeak-mod/wiki/TeamSpeak-Plugins#tessumod-plugin" ) );
 }
 
+void UseCases::showStatistics( QWidget *parent )
+{
+	adapterStorage->getUi()->showStatistics( adapterStorage->getGameData()->getStatistics() + changeFilter.getStatistics(), parent );
+}
+
 void UseCases::positionUserToAudioBackends( const Entity::User &user )
 {
 	if( user.paired() )
@@ -228,7 +261,9 @@ void UseCases::positionUserToAudioBackends( const Entity::User &user )
 		foreach( Interfaces::AudioAdapter *backend, adapterStorage->getAudios() )
 		{
 			backend->positionUser( user );
+			backend->flush();
 		}
+		changeFilter.setUserApplied( user );
 	}
 }
 
@@ -239,7 +274,9 @@ void UseCases::removeUserFromAudioBackends( const Entity::User &user )
 		foreach( Interfaces::AudioAdapter *backend, adapterStorage->getAudios() )
 		{
 			backend->removeUser( user );
+			backend->flush();
 		}
+		changeFilter.removeUser( user.id );
 	}
 }
 
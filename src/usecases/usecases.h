@@ -22,12 +22,14 @@
 
 #include "../interfaces/storages.h"
 #include "../interfaces/adapters.h"
+#include "changefilter.h"
 
 #include <QObject>
 
 namespace Entity
 {
 class Vector;
+class GameState;
 }
 
 namespace UseCase
@@ -40,11 +42,10 @@ class UseCases : public QObject
 public:
 	typedef std::function<void(QVariant)> Callback;
 
+	UseCases( QObject *parent );
+
 	void applicationInitialize();
-	void positionUser( quint16 id, const Entity::Vector& position );
-	void positionCamera( const Entity::Vector& position, const Entity::Vector& direction );
-	void addGameUser( quint16 id );
-	void removeGameUser( quint16 id );
+	void updateGameState( const Entity::GameState &state );
 	void addChatUser( quint16 id );
 	void removeChatUser( quint16 id );
 	void changePlaybackDevice();
@@ -53,6 +54,7 @@ public:
 	void saveSettings( const Entity::Settings &settings );
 	void playTestAudioWithSettings(const Entity::Settings &settings, Callback callback );
 	void showPluginHelp();
+	void showStatistics( QWidget *parent );
 
 private:
 	void positionUserToAudioBackends( const Entity::User &user );
@@ -65,6 +67,9 @@ public:
 	Interfaces::CameraStorage* cameraStorage;
 	Interfaces::SettingsStorage* settingsStorage;
 	Interfaces::AdapterStorage* adapterStorage;
+
+private:
+	ChangeFilter changeFilter;
 };
 
 }
@@ -0,0 +1,84 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include "framequeue.h"
+
+#include <cstring>
+
+FrameQueue::FrameQueue( int capacity )
+	: frames( new Frame[capacity] ), capacity( capacity ), readIndex( 0 ), writeIndex( 0 ), droppedCount( 0 )
+{
+	// indexes wrap around at 2^32, keep slot mapping continuous over the wrap
+	Q_ASSERT( capacity > 0 && ( capacity & ( capacity - 1 ) ) == 0 );
+}
+
+FrameQueue::~FrameQueue()
+{
+	delete[] frames;
+}
+
+bool FrameQueue::push( quint16 clientId, const short *samples, int sampleCount, int channels )
+{
+	const int totalSamples = sampleCount * channels;
+	if( totalSamples <= 0 )
+	{
+		return false;
+	}
+	if( totalSamples > MAX_FRAME_SAMPLES )
+	{
+		droppedCount.fetchAndAddRelaxed( 1 );
+		return false;
+	}
+	// only producer modifies write index, consumer only ever advances read
+	// index so the free space seen here can only grow
+	const quint32 write = writeIndex.load();
+	if( write - readIndex.loadAcquire() >= capacity )
+	{
+		droppedCount.fetchAndAddRelaxed( 1 );
+		return false;
+	}
+	Frame &frame = frames[write % capacity];
+	frame.clientId = clientId;
+	frame.sampleCount = sampleCount;
+	frame.channels = channels;
+	memcpy( frame.samples, samples, totalSamples * sizeof(short) );
+	writeIndex.storeRelease( write + 1 );
+	return true;
+}
+
+const FrameQueue::Frame *FrameQueue::front() const
+{
+	const quint32 read = readIndex.load();
+	if( read == writeIndex.loadAcquire() )
+	{
+		return 0;
+	}
+	return &frames[read % capacity];
+}
+
+void FrameQueue::pop()
+{
+	readIndex.storeRelease( readIndex.load() + 1 );
+}
+
+quint32 FrameQueue::takeDroppedCount()
+{
+	return droppedCount.fetchAndStoreOrdered( 0 );
+}
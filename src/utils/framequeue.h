@@ -0,0 +1,90 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#pragma once
+
+#include <QAtomicInteger>
+
+/**
+ * The FrameQueue class is a fixed size single producer, single consumer
+ * queue of 16 bit PCM audio frames.
+ *
+ * All memory is allocated at construction time and neither pushing nor
+ * popping takes locks or allocates, so frames may be pushed from within
+ * an audio callback while another thread pops them.
+ */
+class FrameQueue
+{
+public:
+	/**
+	 * Maximum amount of samples (of all channels) in a single frame.
+	 * Enough for 40 ms of stereo audio at 48 kHz.
+	 */
+	static const int MAX_FRAME_SAMPLES = 3840;
+
+	struct Frame
+	{
+		quint16 clientId;
+		int sampleCount;
+		int channels;
+		short samples[MAX_FRAME_SAMPLES];
+	};
+
+	/**
+	 * @param capacity amount of frames the queue holds, must be a power of two
+	 */
+	FrameQueue( int capacity );
+	~FrameQueue();
+
+	/**
+	 * Copies given samples to the queue. Must be called only from the
+	 * producer thread.
+	 *
+	 * @returns false if the queue was full or the frame is too large
+	 */
+	bool push( quint16 clientId, const short *samples, int sampleCount, int channels );
+
+	/**
+	 * Returns oldest frame in the queue, or null if the queue is empty.
+	 * Must be called only from the consumer thread.
+	 */
+	const Frame *front() const;
+
+	/**
+	 * Removes oldest frame from the queue. Must be called only from the
+	 * consumer thread.
+	 */
+	void pop();
+
+	/**
+	 * Returns amount of frames which have been rejected due the queue being
+	 * full or the frame being too large and resets the counter.
+	 */
+	quint32 takeDroppedCount();
+
+private:
+	Q_DISABLE_COPY( FrameQueue )
+
+	Frame *frames;
+	quint32 capacity;
+	QAtomicInteger<quint32> readIndex;
+	QAtomicInteger<quint32> writeIndex;
+	QAtomicInteger<quint32> droppedCount;
+};
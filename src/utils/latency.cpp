@@ -0,0 +1,179 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include "latency.h"
+
+#include <QMutex>
+#include <cmath>
+#include <cstring>
+
+#ifdef WIN32
+#include <Windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace
+{
+
+// buckets grow exponentially from 1 µs, with four buckets per doubling
+const qint64 MIN_LATENCY      = 1000; // ns
+const int BUCKETS_PER_OCTAVE  = 4;
+const int OCTAVE_COUNT        = 26; // up to about a minute
+const int BUCKET_COUNT        = OCTAVE_COUNT * BUCKETS_PER_OCTAVE;
+const double PERCENTILES[]    = { 50, 90, 99, 99.9 };
+const int PERCENTILE_COUNT    = sizeof( PERCENTILES ) / sizeof( PERCENTILES[0] );
+
+class Histogram
+{
+public:
+	Histogram()
+		: count( 0 ), maximum( 0 )
+	{
+		memset( buckets, 0, sizeof( buckets ) );
+	}
+
+	void record( qint64 latency )
+	{
+		int bucket = 0;
+		if( latency > MIN_LATENCY )
+		{
+			bucket = qMin<int>( BUCKET_COUNT - 1, std::log2( (double)latency / MIN_LATENCY ) * BUCKETS_PER_OCTAVE );
+		}
+		buckets[bucket]++;
+		count++;
+		maximum = qMax( maximum, latency );
+	}
+
+	/**
+	 * Returns upper bound of bucket which holds given percentile.
+	 */
+	qint64 getPercentile( double percentile ) const
+	{
+		const quint64 target = std::ceil( count * percentile / 100 );
+		quint64 sum = 0;
+		for( int bucket = 0; bucket < BUCKET_COUNT; bucket++ )
+		{
+			sum += buckets[bucket];
+			if( sum >= target )
+			{
+				return qMin<qint64>( maximum, MIN_LATENCY * std::pow( 2.0, (double)( bucket + 1 ) / BUCKETS_PER_OCTAVE ) );
+			}
+		}
+		return maximum;
+	}
+
+	quint64 count;
+	qint64 maximum;
+	quint32 buckets[BUCKET_COUNT];
+};
+
+QString toMilliseconds( qint64 nanoseconds )
+{
+	return QString::number( nanoseconds / 1e6, 'f', 2 ) + " ms";
+}
+
+const char *STAGE_NAMES[] = { "Game write to read", "Read to apply", "Game write to apply" };
+
+QMutex gMutex;
+Histogram gHistograms[Latency::StageCount];
+qint64 gPendingWriteTime = 0;
+qint64 gPendingReadTime = 0;
+
+#ifdef WIN32
+qint64 getFrequency()
+{
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency( &frequency );
+	return frequency.QuadPart;
+}
+#endif
+
+}
+
+namespace Latency
+{
+
+qint64 now()
+{
+#ifdef WIN32
+	static const qint64 frequency = getFrequency();
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter( &counter );
+	// split to avoid overflow of counter * 1e9
+	return counter.QuadPart / frequency * 1000000000 + counter.QuadPart % frequency * 1000000000 / frequency;
+#else
+	timespec time;
+	clock_gettime( CLOCK_MONOTONIC, &time );
+	return (qint64)time.tv_sec * 1000000000 + time.tv_nsec;
+#endif
+}
+
+void record( Stage stage, qint64 latency )
+{
+	QMutexLocker locker( &gMutex );
+	gHistograms[stage].record( latency );
+}
+
+void setPendingUpdate( qint64 writeTime, qint64 readTime )
+{
+	QMutexLocker locker( &gMutex );
+	gPendingWriteTime = writeTime;
+	gPendingReadTime = readTime;
+}
+
+void markUpdateApplied()
+{
+	QMutexLocker locker( &gMutex );
+	if( gPendingReadTime == 0 )
+	{
+		return;
+	}
+	const qint64 time = now();
+	gHistograms[ReadToApply].record( time - gPendingReadTime );
+	if( gPendingWriteTime != 0 )
+	{
+		gHistograms[WriteToApply].record( time - gPendingWriteTime );
+	}
+	gPendingWriteTime = gPendingReadTime = 0;
+}
+
+QStringList getReport()
+{
+	QMutexLocker locker( &gMutex );
+	QStringList lines;
+	for( int stage = 0; stage < StageCount; stage++ )
+	{
+		const Histogram &histogram = gHistograms[stage];
+		QString line = QString( STAGE_NAMES[stage] ) + ": " + QString::number( histogram.count ) + " samples";
+		if( histogram.count > 0 )
+		{
+			for( int i = 0; i < PERCENTILE_COUNT; i++ )
+			{
+				line += ", p" + QString::number( PERCENTILES[i] ) + " " + toMilliseconds( histogram.getPercentile( PERCENTILES[i] ) );
+			}
+			line += ", max " + toMilliseconds( histogram.maximum );
+		}
+		lines.append( line );
+	}
+	return lines;
+}
+
+}
@@ -0,0 +1,65 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#pragma once
+
+#include <QtGlobal>
+#include <QStringList>
+
+/**
+ * Latency measurement of positional data from game's write to the audio
+ * backends.
+ *
+ * Times are nanoseconds of a monotonic clock shared by all processes in the
+ * machine, QueryPerformanceCounter() in Windows and CLOCK_MONOTONIC
+ * elsewhere, so that the game can timestamp its writes with the same clock.
+ * Latencies are collected to histograms whose percentiles are reported on
+ * request.
+ */
+namespace Latency
+{
+
+enum Stage
+{
+	WriteToRead,
+	ReadToApply,
+	WriteToApply,
+	StageCount
+};
+
+qint64 now();
+
+void record( Stage stage, qint64 latency );
+
+/**
+ * Sets write and read time of the newest data given to audio backends, zero
+ * if unknown.
+ */
+void setPendingUpdate( qint64 writeTime, qint64 readTime );
+
+/**
+ * Records latency of the pending update, called by audio backends when they
+ * have applied positions. Does nothing if there is no pending update.
+ */
+void markUpdateApplied();
+
+QStringList getReport();
+
+}
@@ -0,0 +1,209 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include "namedevent.h"
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#endif
+
+namespace {
+
+#ifdef WIN32
+QString getLastErrorString()
+{
+	wchar_t *string = NULL;
+	FormatMessage( FORMAT_MESSAGE_ALLOCATE_BUFFER|FORMAT_MESSAGE_FROM_SYSTEM,
+				   NULL,
+				   GetLastError(),
+				   MAKELANGID( LANG_NEUTRAL, SUBLANG_DEFAULT ),
+				   (LPWSTR)&string,
+				   0,
+				   NULL );
+	QString message = QString::fromWCharArray( string );
+	LocalFree( (HLOCAL)string );
+	return message;
+}
+#else
+QByteArray toSemaphoreName( const QString &name )
+{
+	return ( "/" + name ).toLocal8Bit();
+}
+#endif
+
+}
+
+NamedEvent::NamedEvent( const QString &name )
+	: name( name ),
+#ifdef WIN32
+	  handle( NULL )
+#else
+	  semaphore( SEM_FAILED ), owner( false )
+#endif
+{
+}
+
+NamedEvent::~NamedEvent()
+{
+	close();
+}
+
+bool NamedEvent::create()
+{
+	close();
+#ifdef WIN32
+	handle = CreateEventW( NULL, FALSE, FALSE, (wchar_t*)name.utf16() );
+	if( !handle )
+	{
+		error = getLastErrorString();
+		return false;
+	}
+#else
+	semaphore = sem_open( toSemaphoreName( name ).constData(), O_CREAT | O_EXCL, 0600, 0 );
+	if( semaphore != SEM_FAILED )
+	{
+		owner = true;
+	}
+	else if( errno == EEXIST )
+	{
+		// created by the other side, which also removes it
+		semaphore = sem_open( toSemaphoreName( name ).constData(), 0 );
+	}
+	if( semaphore == SEM_FAILED )
+	{
+		error = strerror( errno );
+		return false;
+	}
+#endif
+	return true;
+}
+
+bool NamedEvent::open()
+{
+	close();
+#ifdef WIN32
+	handle = OpenEventW( EVENT_MODIFY_STATE | SYNCHRONIZE, FALSE, (wchar_t*)name.utf16() );
+	if( !handle )
+	{
+		error = getLastErrorString();
+		return false;
+	}
+#else
+	semaphore = sem_open( toSemaphoreName( name ).constData(), 0 );
+	if( semaphore == SEM_FAILED )
+	{
+		error = strerror( errno );
+		return false;
+	}
+#endif
+	return true;
+}
+
+void NamedEvent::close()
+{
+#ifdef WIN32
+	if( handle )
+	{
+		CloseHandle( handle );
+		handle = NULL;
+	}
+#else
+	if( semaphore != SEM_FAILED )
+	{
+		sem_close( semaphore );
+		semaphore = SEM_FAILED;
+		// semaphore lives until unlinked, remove it with its creator
+		if( owner )
+		{
+			sem_unlink( toSemaphoreName( name ).constData() );
+			owner = false;
+		}
+	}
+#endif
+}
+
+bool NamedEvent::isValid() const
+{
+#ifdef WIN32
+	return handle != NULL;
+#else
+	return semaphore != SEM_FAILED;
+#endif
+}
+
+QString NamedEvent::errorString() const
+{
+	return error;
+}
+
+void NamedEvent::signal()
+{
+#ifdef WIN32
+	if( handle )
+	{
+		SetEvent( handle );
+	}
+#else
+	if( semaphore != SEM_FAILED )
+	{
+		sem_post( semaphore );
+	}
+#endif
+}
+
+bool NamedEvent::wait( int timeoutMs )
+{
+#ifdef WIN32
+	return handle && WaitForSingleObject( handle, timeoutMs < 0? INFINITE: DWORD( timeoutMs ) ) == WAIT_OBJECT_0;
+#else
+	if( semaphore == SEM_FAILED )
+	{
+		return false;
+	}
+	int result;
+	if( timeoutMs < 0 )
+	{
+		while( ( result = sem_wait( semaphore ) ) == -1 && errno == EINTR );
+	}
+	else
+	{
+		timespec deadline;
+		clock_gettime( CLOCK_REALTIME, &deadline );
+		deadline.tv_sec += timeoutMs / 1000;
+		deadline.tv_nsec += ( timeoutMs % 1000 ) * 1000000L;
+		if( deadline.tv_nsec >= 1000000000L )
+		{
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000L;
+		}
+		while( ( result = sem_timedwait( semaphore, &deadline ) ) == -1 && errno == EINTR );
+	}
+	if( result != 0 )
+	{
+		return false;
+	}
+	// coalesce signals posted since previous wait into this wakeup
+	while( sem_trywait( semaphore ) == 0 );
+	return true;
+#endif
+}
@@ -0,0 +1,86 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#pragma once
+
+#include <QString>
+
+#ifdef WIN32
+#include <Windows.h>
+#else
+#include <semaphore.h>
+#endif
+
+/**
+ * The NamedEvent class is an auto-resetting event which can be signalled
+ * from another process by its name.
+ *
+ * In Windows this is a named event object, in Linux a named POSIX semaphore
+ * whose count is drained on each wakeup so that several signals between two
+ * waits wake the waiter only once.
+ */
+class NamedEvent
+{
+public:
+	NamedEvent( const QString &name );
+	~NamedEvent();
+
+	/**
+	 * Creates the event, or opens it if another process has created it
+	 * already. In Linux the event is removed on close() only if it was
+	 * created here.
+	 */
+	bool create();
+
+	/**
+	 * Opens event created by another process.
+	 */
+	bool open();
+
+	void close();
+	bool isValid() const;
+	QString errorString() const;
+
+	/**
+	 * Wakes up the waiter, if there is one. Otherwise next wait() returns
+	 * immediately.
+	 */
+	void signal();
+
+	/**
+	 * Blocks until the event is signalled or timeout expires.
+	 *
+	 * @param timeoutMs timeout in milliseconds, negative to wait forever
+	 * @returns true if the event was signalled
+	 */
+	bool wait( int timeoutMs );
+
+private:
+	Q_DISABLE_COPY( NamedEvent )
+
+	QString name;
+	QString error;
+#ifdef WIN32
+	HANDLE handle;
+#else
+	sem_t *semaphore;
+	bool owner;
+#endif
+};
@@ -0,0 +1,159 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include "pcmconvert.h"
+
+#include <cmath>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define PCMCONVERT_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+
+const float INT16_SCALE = 1.0f / 32768.0f;
+
+// rounds half to even like the SSE2 conversion does, so that the vector
+// body and the scalar tail of a kernel give the same samples
+inline short saturate( float value )
+{
+	return value >= 32767.0f? 32767: value <= -32768.0f? -32768: short( std::lrint( value ) );
+}
+
+// mixes channels of one frame, returns the sum of channel samples
+inline int mixFrame( const short *frame, int channels )
+{
+	int sum = 0;
+	for( int channel = 0; channel < channels; channel++ )
+	{
+		sum += frame[channel];
+	}
+	return sum;
+}
+
+#ifdef PCMCONVERT_SSE2
+
+// returns sums of channels for four frames from 'input' as floats
+inline __m128 mixFourFrames( const short *input, int channels )
+{
+	if( channels == 1 )
+	{
+		// sign extend four 16 bit samples into 32 bit integers
+		__m128i samples = _mm_loadl_epi64( reinterpret_cast<const __m128i*>( input ) );
+		return _mm_cvtepi32_ps( _mm_srai_epi32( _mm_unpacklo_epi16( samples, samples ), 16 ) );
+	}
+	// stereo, multiply-add with ones sums left and right of each frame
+	__m128i samples = _mm_loadu_si128( reinterpret_cast<const __m128i*>( input ) );
+	return _mm_cvtepi32_ps( _mm_madd_epi16( samples, _mm_set1_epi16( 1 ) ) );
+}
+
+#endif
+
+}
+
+namespace PcmConvert
+{
+
+void downmixToFloat( const short *input, int frameCount, int channels, float gain, float *output )
+{
+	const float scale = gain * INT16_SCALE / channels;
+	int frame = 0;
+#ifdef PCMCONVERT_SSE2
+	if( channels == 1 || channels == 2 )
+	{
+		const __m128 scales = _mm_set1_ps( scale );
+		for( ; frame + 4 <= frameCount; frame += 4 )
+		{
+			_mm_storeu_ps( output + frame, _mm_mul_ps( mixFourFrames( input + frame * channels, channels ), scales ) );
+		}
+	}
+#endif
+	for( ; frame < frameCount; frame++ )
+	{
+		output[frame] = mixFrame( input + frame * channels, channels ) * scale;
+	}
+}
+
+void downmixToInt16( const short *input, int frameCount, int channels, float gain, short *output )
+{
+	const float scale = gain / channels;
+	int frame = 0;
+#ifdef PCMCONVERT_SSE2
+	if( channels == 1 || channels == 2 )
+	{
+		const __m128 scales = _mm_set1_ps( scale );
+		for( ; frame + 8 <= frameCount; frame += 8 )
+		{
+			// convert with rounding and pack with signed saturation
+			__m128i low = _mm_cvtps_epi32( _mm_mul_ps( mixFourFrames( input + frame * channels, channels ), scales ) );
+			__m128i high = _mm_cvtps_epi32( _mm_mul_ps( mixFourFrames( input + ( frame + 4 ) * channels, channels ), scales ) );
+			_mm_storeu_si128( reinterpret_cast<__m128i*>( output + frame ), _mm_packs_epi32( low, high ) );
+		}
+	}
+#endif
+	for( ; frame < frameCount; frame++ )
+	{
+		output[frame] = saturate( mixFrame( input + frame * channels, channels ) * scale );
+	}
+}
+
+void rampGain( float *samples, int frameCount, float fromGain, float toGain )
+{
+	const float step = frameCount > 0? ( toGain - fromGain ) / frameCount: 0;
+	for( int frame = 0; frame < frameCount; frame++ )
+	{
+		samples[frame] *= fromGain + step * frame;
+	}
+}
+
+void rampGain( short *samples, int frameCount, float fromGain, float toGain )
+{
+	const float step = frameCount > 0? ( toGain - fromGain ) / frameCount: 0;
+	for( int frame = 0; frame < frameCount; frame++ )
+	{
+		samples[frame] = saturate( samples[frame] * ( fromGain + step * frame ) );
+	}
+}
+
+void panToStereo( const float *input, int frameCount, float fromLeft, float fromRight, float toLeft, float toRight, float *output )
+{
+	const float leftStep = frameCount > 0? ( toLeft - fromLeft ) / frameCount: 0;
+	const float rightStep = frameCount > 0? ( toRight - fromRight ) / frameCount: 0;
+	for( int frame = 0; frame < frameCount; frame++ )
+	{
+		output[frame * 2] = input[frame] * ( fromLeft + leftStep * frame );
+		output[frame * 2 + 1] = input[frame] * ( fromRight + rightStep * frame );
+	}
+}
+
+void panToStereo( const short *input, int frameCount, float fromLeft, float fromRight, float toLeft, float toRight, short *output )
+{
+	const float leftStep = frameCount > 0? ( toLeft - fromLeft ) / frameCount: 0;
+	const float rightStep = frameCount > 0? ( toRight - fromRight ) / frameCount: 0;
+	for( int frame = 0; frame < frameCount; frame++ )
+	{
+		output[frame * 2] = saturate( input[frame] * ( fromLeft + leftStep * frame ) );
+		output[frame * 2 + 1] = saturate( input[frame] * ( fromRight + rightStep * frame ) );
+	}
+}
+
+}
@@ -0,0 +1,83 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#pragma once
+
+#include <QtGlobal>
+
+/**
+ * @file
+ *
+ * Conversion of interleaved 16 bit PCM audio to mono.
+ *
+ * The functions mix all channels of each frame into one sample, scaled by
+ * given gain, within a single pass over the data. Mono and stereo input are
+ * vectorized with SSE2 when the compiler targets it, other channel counts and
+ * targets use a scalar loop.
+ *
+ * Mono results can be faded or panned to stereo with gains which change
+ * linearly over the frame, avoiding clicks when gains change between frames.
+ */
+
+namespace PcmConvert
+{
+
+/**
+ * Downmixes 16 bit audio to mono 32 bit float samples in range [-1, 1].
+ *
+ * @param input      interleaved input samples
+ * @param frameCount amount of frames (samples per channel) in input
+ * @param channels   channel count of input
+ * @param gain       multiplier applied to the mixed samples
+ * @param output     destination for frameCount samples
+ */
+void downmixToFloat( const short *input, int frameCount, int channels, float gain, float *output );
+
+/**
+ * Downmixes 16 bit audio to mono 16 bit samples, rounding half to even and
+ * saturating samples which exceed the range.
+ *
+ * @param input      interleaved input samples
+ * @param frameCount amount of frames (samples per channel) in input
+ * @param channels   channel count of input
+ * @param gain       multiplier applied to the mixed samples
+ * @param output     destination for frameCount samples
+ */
+void downmixToInt16( const short *input, int frameCount, int channels, float gain, short *output );
+
+/**
+ * Multiplies mono samples in place with gain which changes linearly from
+ * @a fromGain to @a toGain over the samples.
+ */
+void rampGain( float *samples, int frameCount, float fromGain, float toGain );
+void rampGain( short *samples, int frameCount, float fromGain, float toGain );
+
+/**
+ * Pans mono samples to interleaved stereo, left and right gains change
+ * linearly from the 'from' gains to the 'to' gains over the samples.
+ *
+ * @param input      mono input samples
+ * @param frameCount amount of samples in input
+ * @param output     destination for frameCount * 2 samples
+ */
+void panToStereo( const float *input, int frameCount, float fromLeft, float fromRight, float toLeft, float toRight, float *output );
+void panToStereo( const short *input, int frameCount, float fromLeft, float fromRight, float toLeft, float toRight, short *output );
+
+}
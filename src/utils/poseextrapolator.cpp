@@ -0,0 +1,359 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include "poseextrapolator.h"
+
+#include <QTimer>
+#include <cmath>
+
+namespace
+{
+const int DEFAULT_UPDATE_RATE       = 60; // per second
+const qreal DEFAULT_SAMPLE_INTERVAL = 100; // ms, game's tick
+const qreal MAX_SAMPLE_INTERVAL     = 500; // ms
+const qreal SAMPLE_INTERVAL_GAIN    = 0.125;
+// missed samples after which a target is assumed to have stopped
+const qreal STOP_TIMEOUT_SAMPLES    = 1.5;
+// time constant of blending away error of previous extrapolation
+const qreal CORRECTION_TIME         = 50; // ms
+const qreal SETTLE_TIME             = 5 * CORRECTION_TIME; // ms
+const qreal MIN_ROTATION_SINE       = 1e-6;
+// faster moves are camera cuts (e.g. zooming to sniper mode) which are
+// jumped to rather than extrapolated
+const qreal MAX_SPEED               = 100; // m/s
+
+/**
+ * Returns rotation from unit vector 'from' to unit vector 'to' as an axis
+ * and an angle in radians.
+ */
+void getRotation( const Entity::Vector &from, const Entity::Vector &to, Entity::Vector &axis, qreal &angle )
+{
+	const Entity::Vector cross = from.crossProduct( to );
+	const qreal sine = cross.getLength();
+	if( sine < MIN_ROTATION_SINE )
+	{
+		axis = Entity::Vector();
+		angle = 0;
+		return;
+	}
+	axis = cross / sine;
+	angle = std::atan2( sine, from.dotProduct( to ) );
+}
+
+/**
+ * Rotates vector around unit axis by angle in radians (Rodrigues' formula).
+ */
+Entity::Vector rotate( const Entity::Vector &vector, const Entity::Vector &axis, qreal angle )
+{
+	if( angle == 0 )
+	{
+		return vector;
+	}
+	const qreal cosine = std::cos( angle );
+	return vector * cosine
+		+ axis.crossProduct( vector ) * std::sin( angle )
+		+ axis * ( axis.dotProduct( vector ) * ( 1 - cosine ) );
+}
+
+qreal getCorrectionFactor( qreal age )
+{
+	return std::exp( -age / CORRECTION_TIME );
+}
+
+/**
+ * Returns how far in seconds the movement of a track is extrapolated after
+ * given age. After stop timeout the extrapolation is pulled back to the last
+ * sample.
+ */
+qreal getExtrapolationTime( qreal age, qreal stopTimeout )
+{
+	if( age <= stopTimeout )
+	{
+		return age / 1000.0;
+	}
+	return stopTimeout / 1000.0 * getCorrectionFactor( age - stopTimeout );
+}
+
+}
+
+PoseExtrapolator::Track::Track()
+	: sampleTime( -1 ), sampleInterval( DEFAULT_SAMPLE_INTERVAL ), moving( false ), active( false )
+{
+}
+
+PoseExtrapolator::DirectionTrack::DirectionTrack()
+	: angularRate( 0 ), correctionAngle( 0 )
+{
+}
+
+qreal PoseExtrapolator::Track::getStopTimeout() const
+{
+	return STOP_TIMEOUT_SAMPLES * sampleInterval;
+}
+
+PoseExtrapolator::PoseExtrapolator( QObject *parent )
+	: QObject( parent ), timer( new QTimer( this ) ), hasCamera( false ), updateRate( DEFAULT_UPDATE_RATE ),
+	  writeTime( 0 ), readTime( 0 )
+{
+	connect( timer, SIGNAL(timeout()), this, SLOT(onTimeout()) );
+	timer->setTimerType( Qt::PreciseTimer );
+	timer->setInterval( 1000 / updateRate );
+	timer->setSingleShot( false );
+	clock.start();
+}
+
+void PoseExtrapolator::setUpdateRate( int rate )
+{
+	updateRate = qMax( 0, rate );
+	if( updateRate > 0 )
+	{
+		timer->setInterval( 1000 / updateRate );
+		return;
+	}
+	// output the samples as they are from now on
+	timer->stop();
+	for( auto it = users.begin(); it != users.end(); ++it )
+	{
+		it.value().active = false;
+		addUserOutput( it.key(), it.value().position );
+	}
+	if( hasCamera )
+	{
+		cameraPosition.active = cameraDirection.active = false;
+		setCameraOutput( cameraPosition.position, cameraDirection.position );
+	}
+	emitOutput();
+}
+
+void PoseExtrapolator::update( const Entity::GameState &state )
+{
+	const qint64 now = clock.elapsed();
+	if( state.readTime != 0 )
+	{
+		writeTime = state.writeTime;
+		readTime = state.readTime;
+	}
+	output.addedUsers += state.addedUsers;
+	output.removedUsers += state.removedUsers;
+	foreach( quint16 id, state.removedUsers )
+	{
+		users.remove( id );
+	}
+	foreach( const Entity::UserPosition &user, state.movedUsers )
+	{
+		setUserPosition( user.id, user.position, now );
+	}
+	if( state.cameraChanged && state.cameraDirection != Entity::Vector() )
+	{
+		setCameraPose( state.cameraPosition, state.cameraDirection, now );
+	}
+	emitOutput();
+}
+
+void PoseExtrapolator::setUserPosition( quint16 id, const Entity::Vector &position, qint64 now )
+{
+	const bool isNew = !users.contains( id );
+	Track &track = users[id];
+	addSample( track, position, now );
+	if( isNew || updateRate == 0 )
+	{
+		track.active = updateRate > 0;
+		addUserOutput( id, position );
+	}
+	startTimer();
+}
+
+void PoseExtrapolator::setCameraPose( const Entity::Vector &position, const Entity::Vector &direction, qint64 now )
+{
+	addSample( cameraPosition, position, now );
+	addSample( cameraDirection, direction, now );
+	if( !hasCamera || updateRate == 0 )
+	{
+		hasCamera = true;
+		cameraPosition.active = cameraDirection.active = updateRate > 0;
+		setCameraOutput( position, direction );
+	}
+	startTimer();
+}
+
+void PoseExtrapolator::onTimeout()
+{
+	const qint64 now = clock.elapsed();
+	bool isActive = false;
+	for( auto it = users.begin(); it != users.end(); ++it )
+	{
+		Track &track = it.value();
+		if( !track.active )
+		{
+			continue;
+		}
+		if( isSettled( track, now ) )
+		{
+			track.active = false;
+			addUserOutput( it.key(), track.position );
+		}
+		else
+		{
+			isActive = true;
+			addUserOutput( it.key(), getPosition( track, now ) );
+		}
+	}
+	if( cameraPosition.active || cameraDirection.active )
+	{
+		if( isSettled( cameraPosition, now ) && isSettled( cameraDirection, now ) )
+		{
+			cameraPosition.active = cameraDirection.active = false;
+			setCameraOutput( cameraPosition.position, cameraDirection.position );
+		}
+		else
+		{
+			isActive = true;
+			setCameraOutput( getPosition( cameraPosition, now ), getDirection( cameraDirection, now ) );
+		}
+	}
+	if( !isActive )
+	{
+		timer->stop();
+	}
+	emitOutput();
+}
+
+void PoseExtrapolator::addSample( Track &track, const Entity::Vector &position, qint64 now )
+{
+	const qint64 elapsed = now - track.sampleTime;
+	if( track.sampleTime < 0 )
+	{
+		track.velocity = Entity::Vector();
+		track.correction = Entity::Vector();
+		track.moving = false;
+	}
+	else
+	{
+		const Entity::Vector output = getPosition( track, now );
+		const qreal distance = ( position - track.position ).getLength();
+		const bool isJump = distance > MAX_SPEED * qMax<qreal>( elapsed, DEFAULT_SAMPLE_INTERVAL ) / 1000.0;
+		if( track.moving && elapsed > 0 && elapsed <= track.getStopTimeout() && !isJump )
+		{
+			track.sampleInterval += ( qMin<qreal>( elapsed, MAX_SAMPLE_INTERVAL ) - track.sampleInterval ) * SAMPLE_INTERVAL_GAIN;
+			track.velocity = ( position - track.position ) / ( elapsed / 1000.0 );
+		}
+		else
+		{
+			// speed is unknown until second sample of a movement
+			track.velocity = Entity::Vector();
+		}
+		track.moving = position != track.position && !isJump;
+		track.correction = isJump? Entity::Vector(): output - position;
+	}
+	track.position = position;
+	track.sampleTime = now;
+	track.active = true;
+}
+
+void PoseExtrapolator::addSample( DirectionTrack &track, const Entity::Vector &direction, qint64 now )
+{
+	const qint64 elapsed = now - track.sampleTime;
+	if( track.sampleTime < 0 )
+	{
+		track.angularRate = 0;
+		track.correctionAngle = 0;
+		track.moving = false;
+	}
+	else
+	{
+		const Entity::Vector output = getDirection( track, now );
+		if( track.moving && elapsed > 0 && elapsed <= track.getStopTimeout() )
+		{
+			track.sampleInterval += ( qMin<qreal>( elapsed, MAX_SAMPLE_INTERVAL ) - track.sampleInterval ) * SAMPLE_INTERVAL_GAIN;
+			qreal angle;
+			getRotation( track.position.getUnit(), direction.getUnit(), track.axis, angle );
+			track.angularRate = angle / ( elapsed / 1000.0 );
+		}
+		else
+		{
+			track.angularRate = 0;
+		}
+		track.moving = direction != track.position;
+		getRotation( direction.getUnit(), output.getUnit(), track.correctionAxis, track.correctionAngle );
+	}
+	track.position = direction;
+	track.sampleTime = now;
+	track.active = true;
+}
+
+bool PoseExtrapolator::isSettled( const Track &track, qint64 now ) const
+{
+	// without new samples the target is assumed to have stopped, output
+	// settles to last sample once extrapolation and correction have run out
+	return now - track.sampleTime >= track.getStopTimeout() + SETTLE_TIME;
+}
+
+Entity::Vector PoseExtrapolator::getPosition( const Track &track, qint64 now ) const
+{
+	const qreal age = now - track.sampleTime;
+	const qreal extrapolationTime = getExtrapolationTime( age, track.getStopTimeout() );
+	return track.position + track.velocity * extrapolationTime + track.correction * getCorrectionFactor( age );
+}
+
+Entity::Vector PoseExtrapolator::getDirection( const DirectionTrack &track, qint64 now ) const
+{
+	const qreal age = now - track.sampleTime;
+	const qreal extrapolationTime = getExtrapolationTime( age, track.getStopTimeout() );
+	const Entity::Vector direction = rotate( track.position, track.axis, track.angularRate * extrapolationTime );
+	return rotate( direction, track.correctionAxis, track.correctionAngle * getCorrectionFactor( age ) );
+}
+
+void PoseExtrapolator::addUserOutput( quint16 id, const Entity::Vector &position )
+{
+	Entity::UserPosition user;
+	user.id = id;
+	user.position = position;
+	output.movedUsers.append( user );
+}
+
+void PoseExtrapolator::setCameraOutput( const Entity::Vector &position, const Entity::Vector &direction )
+{
+	output.cameraChanged = true;
+	output.cameraPosition = position;
+	output.cameraDirection = direction;
+}
+
+void PoseExtrapolator::emitOutput()
+{
+	if( !output.isEmpty() )
+	{
+		output.writeTime = writeTime;
+		output.readTime = readTime;
+		emit stateChanged( output );
+		output.clear();
+	}
+	// only the first output after a fresh sample measures pipeline latency,
+	// extrapolated outputs after it would just measure the sample's age
+	writeTime = 0;
+	readTime = 0;
+}
+
+void PoseExtrapolator::startTimer()
+{
+	if( updateRate > 0 && !timer->isActive() )
+	{
+		timer->start();
+	}
+}
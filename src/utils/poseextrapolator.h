@@ -0,0 +1,129 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QMap>
+#include <QElapsedTimer>
+#include "../entities/vector.h"
+#include "../entities/gamestate.h"
+
+class QTimer;
+
+/**
+ * The PoseExtrapolator class smooths positions and camera direction received
+ * at game's tick rate to updates at a steady, higher rate.
+ *
+ * Velocity and angular rate are estimated from consecutive samples and used
+ * to extrapolate poses between the samples. When a new sample arrives the
+ * error of previous extrapolation is blended away over a short while instead
+ * of jumping to the new pose. A target which gets no new samples is assumed
+ * to have stopped and settles to its last sample, after which the timer
+ * stops until next sample.
+ *
+ * Added and removed users are passed through as they are. All changes of one
+ * sample or update are emitted together as one state.
+ */
+class PoseExtrapolator : public QObject
+{
+	Q_OBJECT
+
+public:
+	PoseExtrapolator( QObject *parent );
+
+	/**
+	 * Sets rate of updates per second. Zero disables extrapolation, in which
+	 * case samples are passed through as they are.
+	 */
+	void setUpdateRate( int rate );
+
+	/**
+	 * Takes changes in game state as new samples. Camera with zero direction
+	 * is ignored.
+	 */
+	void update( const Entity::GameState &state );
+
+signals:
+	void stateChanged( const Entity::GameState &state );
+
+private slots:
+	void onTimeout();
+
+private:
+	struct Track
+	{
+		Track();
+
+		qreal getStopTimeout() const;
+
+		// time of last sample in milliseconds, negative if none
+		qint64 sampleTime;
+		// average time between samples in milliseconds
+		qreal sampleInterval;
+		// true if last samples differed from each other
+		bool moving;
+		// true until output has settled to last sample
+		bool active;
+		// last sample
+		Entity::Vector position;
+		Entity::Vector velocity;
+		// error of previous output, decays towards zero
+		Entity::Vector correction;
+	};
+
+	struct DirectionTrack : public Track
+	{
+		DirectionTrack();
+
+		// rotation per second around axis
+		Entity::Vector axis;
+		qreal angularRate;
+		// rotation from sample to previous output, decays towards zero
+		Entity::Vector correctionAxis;
+		qreal correctionAngle;
+	};
+
+	void setUserPosition( quint16 id, const Entity::Vector &position, qint64 now );
+	void setCameraPose( const Entity::Vector &position, const Entity::Vector &direction, qint64 now );
+	void addSample( Track &track, const Entity::Vector &position, qint64 now );
+	void addSample( DirectionTrack &track, const Entity::Vector &direction, qint64 now );
+	bool isSettled( const Track &track, qint64 now ) const;
+	Entity::Vector getPosition( const Track &track, qint64 now ) const;
+	Entity::Vector getDirection( const DirectionTrack &track, qint64 now ) const;
+	void addUserOutput( quint16 id, const Entity::Vector &position );
+	void setCameraOutput( const Entity::Vector &position, const Entity::Vector &direction );
+	void emitOutput();
+	void startTimer();
+
+private:
+	QTimer *timer;
+	QElapsedTimer clock;
+	QMap<quint16, Track> users;
+	Track cameraPosition;
+	DirectionTrack cameraDirection;
+	bool hasCamera;
+	int updateRate;
+	// times of a fresh sample, passed on with the next output only
+	qint64 writeTime;
+	qint64 readTime;
+	// changes since previous emit, reused between emits
+	Entity::GameState output;
+};
@@ -0,0 +1,102 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include "wakeupevent.h"
+
+#ifndef WIN32
+#include <errno.h>
+#include <time.h>
+#endif
+
+WakeupEvent::WakeupEvent()
+{
+#ifdef WIN32
+	handle = CreateEventW( NULL, FALSE, FALSE, NULL );
+#else
+	valid = sem_init( &semaphore, 0, 0 ) == 0;
+#endif
+}
+
+WakeupEvent::~WakeupEvent()
+{
+#ifdef WIN32
+	if( handle )
+	{
+		CloseHandle( handle );
+	}
+#else
+	if( valid )
+	{
+		sem_destroy( &semaphore );
+	}
+#endif
+}
+
+void WakeupEvent::signal()
+{
+#ifdef WIN32
+	if( handle )
+	{
+		SetEvent( handle );
+	}
+#else
+	if( valid )
+	{
+		sem_post( &semaphore );
+	}
+#endif
+}
+
+bool WakeupEvent::wait( int timeoutMs )
+{
+#ifdef WIN32
+	return handle && WaitForSingleObject( handle, timeoutMs < 0? INFINITE: DWORD( timeoutMs ) ) == WAIT_OBJECT_0;
+#else
+	if( !valid )
+	{
+		return false;
+	}
+	int result;
+	if( timeoutMs < 0 )
+	{
+		while( ( result = sem_wait( &semaphore ) ) == -1 && errno == EINTR );
+	}
+	else
+	{
+		timespec deadline;
+		clock_gettime( CLOCK_REALTIME, &deadline );
+		deadline.tv_sec += timeoutMs / 1000;
+		deadline.tv_nsec += ( timeoutMs % 1000 ) * 1000000L;
+		if( deadline.tv_nsec >= 1000000000L )
+		{
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000L;
+		}
+		while( ( result = sem_timedwait( &semaphore, &deadline ) ) == -1 && errno == EINTR );
+	}
+	if( result != 0 )
+	{
+		return false;
+	}
+	// coalesce signals posted since previous wait into this wakeup
+	while( sem_trywait( &semaphore ) == 0 );
+	return true;
+#endif
+}
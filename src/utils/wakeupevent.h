@@ -0,0 +1,69 @@
+/*
+ * TessuMod: Mod for integrating TeamSpeak into World of Tanks
+ * Copyright (C) 2015  Janne Hakonen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#pragma once
+
+#include <QtGlobal>
+
+#ifdef WIN32
+#include <Windows.h>
+#else
+#include <semaphore.h>
+#endif
+
+/**
+ * The WakeupEvent class is an auto-resetting event for waking up a thread
+ * of the same process.
+ *
+ * In Windows this is an unnamed event object, in Linux an unnamed POSIX
+ * semaphore whose count is drained on each wakeup. Signalling takes no user
+ * space locks, so unlike QSemaphore or QWaitCondition it may be signalled
+ * from within an audio callback.
+ */
+class WakeupEvent
+{
+public:
+	WakeupEvent();
+	~WakeupEvent();
+
+	/**
+	 * Wakes up the waiter, if there is one. Otherwise next wait() returns
+	 * immediately.
+	 */
+	void signal();
+
+	/**
+	 * Blocks until the event is signalled or timeout expires.
+	 *
+	 * @param timeoutMs timeout in milliseconds, negative to wait forever
+	 * @returns true if the event was signalled
+	 */
+	bool wait( int timeoutMs );
+
+private:
+	Q_DISABLE_COPY( WakeupEvent )
+
+#ifdef WIN32
+	HANDLE handle;
+#else
+	sem_t semaphore;
+	bool valid;
+#endif
+};
@@ -104,6 +104,7 @@ ts3_plugin.commands = python $$PWD/bin/make-installer.py \
 	"$${TARGET_FILE_PATH}" \
 	"$$PWD/audio/testsound.wav" \
 	"$$PWD/etc/alsoft.ini" \
+	"$$PWD/etc/default-48000.mhr" \
 	"$$PWD/etc/hrtfs/*.mhr"
 win32:ts3_plugin.commands += "$$PWD/bin/OpenAL64.dll"
 
@@ -131,6 +132,8 @@ SOURCES += \
 	src/entities/user.cpp \
 	src/entities/vector.cpp \
 	src/entities/camera.cpp \
+	src/entities/gamestate.cpp \
+	src/usecases/changefilter.cpp \
 	src/usecases/usecasefactory.cpp \
 	src/usecases/usecases.cpp \
 	src/storages/userstorage.cpp \
@@ -144,17 +147,27 @@ SOURCES += \
 	src/drivers/openalbackend.cpp \
 	src/drivers/teamspeakplugin.cpp \
 	src/drivers/wotconnector.cpp \
+	src/drivers/wotsimulator.cpp \
+	src/drivers/wottrace.cpp \
+	src/drivers/wotreplay.cpp \
 	src/adapters/uiadapter.cpp \
 	src/main.cpp \
 	src/utils/logging.cpp \
 	src/utils/positionrotator.cpp \
+	src/utils/poseextrapolator.cpp \
+	src/utils/latency.cpp \
 	src/utils/wavfile.cpp \
 	src/utils/async.cpp \
+	src/utils/framequeue.cpp \
+	src/utils/pcmconvert.cpp \
+	src/utils/namedevent.cpp \
+	src/utils/wakeupevent.cpp \
 	src/entities/failures.cpp \
 	src/openal/proxies.cpp \
 	src/openal/openal.cpp \
 	src/openal/structures.cpp \
-	src/openal/privateimpl.cpp
+	src/openal/privateimpl.cpp \
+	src/openal/jittercontroller.cpp
 
 HEADERS +=\
 	src/ui/settingsdialog.h \
@@ -162,6 +175,8 @@ HEADERS +=\
 	src/entities/user.h \
 	src/entities/vector.h \
 	src/entities/camera.h \
+	src/entities/gamestate.h \
+	src/usecases/changefilter.h \
 	src/usecases/usecasefactory.h \
 	src/usecases/usecases.h \
 	src/interfaces/storages.h \
@@ -179,17 +194,28 @@ HEADERS +=\
 	src/drivers/openalbackend.h \
 	src/drivers/teamspeakplugin.h \
 	src/drivers/wotconnector.h \
+	src/drivers/wotsharedmemory.h \
+	src/drivers/wotsimulator.h \
+	src/drivers/wottrace.h \
+	src/drivers/wotreplay.h \
 	src/adapters/uiadapter.h \
 	src/entities/enums.h \
 	src/utils/logging.h \
 	src/utils/positionrotator.h \
+	src/utils/poseextrapolator.h \
+	src/utils/latency.h \
 	src/utils/wavfile.h \
 	src/utils/async.h \
+	src/utils/framequeue.h \
+	src/utils/pcmconvert.h \
+	src/utils/namedevent.h \
+	src/utils/wakeupevent.h \
 	src/entities/failures.h \
 	src/openal/proxies.h \
 	src/openal/openal.h \
 	src/openal/structures.h \
-	src/openal/privateimpl.h
+	src/openal/privateimpl.h \
+	src/openal/jittercontroller.h
 
 FORMS += \
 	src/ui/settingsdialog.ui